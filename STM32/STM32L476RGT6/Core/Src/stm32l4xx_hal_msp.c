@@ -21,6 +21,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 /* USER CODE BEGIN Includes */
+#include <TrinityTrack6000_Config.h>
 
 /* USER CODE END Includes */
 
@@ -117,6 +118,54 @@ void HAL_UART_MspInit(UART_HandleTypeDef* huart)
     GPIO_InitStruct.Alternate = GPIO_AF7_USART2;
     HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
+    /* USART2 DMA Init */
+    /* USART2_TX Init */
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    uart_dma_tx.Instance = DMA1_Channel7;
+    uart_dma_tx.Init.Request = DMA_REQUEST_2;
+    uart_dma_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    uart_dma_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    uart_dma_tx.Init.MemInc = DMA_MINC_ENABLE;
+    uart_dma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    uart_dma_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    uart_dma_tx.Init.Mode = DMA_NORMAL;
+    uart_dma_tx.Init.Priority = DMA_PRIORITY_LOW;
+    if (HAL_DMA_Init(&uart_dma_tx) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    __HAL_LINKDMA(huart,hdmatx,uart_dma_tx);
+
+    /* USART2_RX Init */
+    uart_dma_rx.Instance = DMA1_Channel6;
+    uart_dma_rx.Init.Request = DMA_REQUEST_2;
+    uart_dma_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    uart_dma_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+    uart_dma_rx.Init.MemInc = DMA_MINC_ENABLE;
+    uart_dma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    uart_dma_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    uart_dma_rx.Init.Mode = DMA_CIRCULAR;
+    uart_dma_rx.Init.Priority = DMA_PRIORITY_LOW;
+    if (HAL_DMA_Init(&uart_dma_rx) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    __HAL_LINKDMA(huart,hdmarx,uart_dma_rx);
+
+    /* DMA interrupt init */
+    /* DMA1_Channel7_IRQn interrupt configuration */
+    HAL_NVIC_SetPriority(DMA1_Channel7_IRQn, UART_TX_DMA_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+    /* DMA1_Channel6_IRQn interrupt configuration */
+    HAL_NVIC_SetPriority(DMA1_Channel6_IRQn, UART_RX_DMA_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+
+    /* USART2 interrupt Init */
+    HAL_NVIC_SetPriority(USART2_IRQn, UART_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(USART2_IRQn);
     /* USER CODE BEGIN USART2_MspInit 1 */
 
     /* USER CODE END USART2_MspInit 1 */
@@ -147,6 +196,12 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* huart)
     */
     HAL_GPIO_DeInit(GPIOA, GPIO_PIN_2|GPIO_PIN_3);
 
+    /* USART2 DMA DeInit */
+    HAL_DMA_DeInit(huart->hdmatx);
+    HAL_DMA_DeInit(huart->hdmarx);
+
+    /* USART2 interrupt DeInit */
+    HAL_NVIC_DisableIRQ(USART2_IRQn);
     /* USER CODE BEGIN USART2_MspDeInit 1 */
 
     /* USER CODE END USART2_MspDeInit 1 */
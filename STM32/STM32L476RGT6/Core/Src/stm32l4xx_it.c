@@ -22,6 +22,11 @@
 #include "stm32l4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include <TrinityTrack6000_Config.h>
+#include <TrinityTrack6000_MemHistory.h>
+#include <TrinityTrack6000_Task.h>
+#include <TrinityTrack6000_Errors.h>
+#include <TrinityTrack6000_Idle.h>
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -84,6 +89,11 @@ void NMI_Handler(void)
 void HardFault_Handler(void)
 {
   /* USER CODE BEGIN HardFault_IRQn 0 */
+  if((SCB->CFSR&SCB_CFSR_MEMFAULTSR_Msk)&&taskFaultOverflow()!=TASK_NONE){
+    taskFault(); // Guard hit escalated, e.g. with interrupts masked
+  }
+  global_error_code=ERROR_HARD_FAULT;
+  Error_Handler(); // Crash record and warm restart
 
   /* USER CODE END HardFault_IRQn 0 */
   while (1)
@@ -99,6 +109,7 @@ void HardFault_Handler(void)
 void MemManage_Handler(void)
 {
   /* USER CODE BEGIN MemoryManagement_IRQn 0 */
+  taskFault(); // Guard zone of a task or ERROR_MEM_MANAGE, see TrinityTrack6000_Task.h
 
   /* USER CODE END MemoryManagement_IRQn 0 */
   while (1)
@@ -187,6 +198,7 @@ void SysTick_Handler(void)
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+  memHistoryTick();
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -198,6 +210,60 @@ void SysTick_Handler(void)
 /* please refer to the startup file (startup_stm32l4xx.s).                    */
 /******************************************************************************/
 
+
+/**
+  * @brief This function handles DMA1 channel6 global interrupt.
+  */
+void DMA1_Channel6_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel6_IRQn 0 */
+
+  /* USER CODE END DMA1_Channel6_IRQn 0 */
+  HAL_DMA_IRQHandler(&uart_dma_rx);
+  /* USER CODE BEGIN DMA1_Channel6_IRQn 1 */
+
+  /* USER CODE END DMA1_Channel6_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA1 channel7 global interrupt.
+  */
+void DMA1_Channel7_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel7_IRQn 0 */
+
+  /* USER CODE END DMA1_Channel7_IRQn 0 */
+  HAL_DMA_IRQHandler(&uart_dma_tx);
+  /* USER CODE BEGIN DMA1_Channel7_IRQn 1 */
+
+  /* USER CODE END DMA1_Channel7_IRQn 1 */
+}
+
+/**
+  * @brief This function handles USART2 global interrupt.
+  */
+void USART2_IRQHandler(void)
+{
+  /* USER CODE BEGIN USART2_IRQn 0 */
+
+  /* USER CODE END USART2_IRQn 0 */
+  HAL_UART_IRQHandler(&uart);
+  /* USER CODE BEGIN USART2_IRQn 1 */
+
+  /* USER CODE END USART2_IRQn 1 */
+}
+
+/**
+  * @brief This function handles LPTIM1 global interrupt.
+  */
+void LPTIM1_IRQHandler(void)
+{
+  /* USER CODE BEGIN LPTIM1_IRQn 0 */
+  idleInterrupt(); // Tickless idle wakeup, see TrinityTrack6000_Idle.h
+
+  /* USER CODE END LPTIM1_IRQn 0 */
+}
+
 /* USER CODE BEGIN 1 */
 
 /* USER CODE END 1 */
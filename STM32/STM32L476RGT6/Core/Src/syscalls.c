@@ -29,6 +29,8 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sys/times.h>
+#include <stdint.h>
+#include <TrinityTrack6000_Log.h>
 
 
 /* Variables */
@@ -80,11 +82,11 @@ __attribute__((weak)) int _read(int file, char *ptr, int len)
 __attribute__((weak)) int _write(int file, char *ptr, int len)
 {
   (void)file;
-  int DataIdx;
 
-  for (DataIdx = 0; DataIdx < len; DataIdx++)
+  /* Appended to RAM2 log ring as a whole, drained by DMA UART in background */
+  if (len > 0)
   {
-    __io_putchar(*ptr++);
+    logWrite(ptr, (uint32_t)len);
   }
   return len;
 }
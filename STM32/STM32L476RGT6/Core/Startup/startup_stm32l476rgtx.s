@@ -44,6 +44,22 @@ defined in linker script */
 .word	_sbss
 /* end address for the .bss section. defined in linker script */
 .word	_ebss
+/* lowest address of the stack budget. defined in linker script */
+.word	_sstack
+/* copy table {load, start, end} and zero table {start, end} of every bank. defined in linker script */
+.word	__copy_table_start__
+.word	__copy_table_end__
+.word	__zero_table_start__
+.word	__zero_table_end__
+
+/* pattern of unused stack words, keep in sync with STACK_PAINT_PATTERN */
+.equ  StackPaint,     0xC5C5C5C5
+
+/* cycle counter, started first so the time to main can be reported */
+.equ  DEMCR,          0xE000EDFC
+.equ  DEMCR_TRCENA,   0x01000000
+.equ  DWT_CTRL,       0xE0001000
+.equ  DWT_CYCCNT,     0xE0001004
 
 .equ  BootRAM,        0xF1E0F85F
 /**
@@ -59,50 +75,121 @@ defined in linker script */
 	.weak	Reset_Handler
 	.type	Reset_Handler, %function
 Reset_Handler:
+/* Start the cycle counter from 0 first, the boot timeline starts here */
+  ldr r0, =DEMCR
+  ldr r1, [r0]
+  orr r1, r1, #DEMCR_TRCENA
+  str r1, [r0]
+  ldr r0, =DWT_CTRL
+  movs r1, #0
+  str r1, [r0, #4]
+  ldr r1, [r0]
+  orr r1, r1, #1
+  str r1, [r0]
+
   ldr   sp, =_estack    /* Set stack pointer */
 
+/* Paint the stack budget, nothing is pushed yet. Used for high-water mark */
+  ldr r1, =_sstack
+  ldr r2, =_estack
+  ldr r3, =StackPaint
+  bl FillSection
+
 /* Call the clock system initialization function.*/
     bl  SystemInit
 
-/* Copy the data segment initializers from flash to SRAM */
-  ldr r0, =_sdata
-  ldr r1, =_edata
-  ldr r2, =_sidata
-  movs r3, #0
-  b LoopCopyDataInit
-
-CopyDataInit:
-  ldr r4, [r2, r3]
-  str r4, [r0, r3]
-  adds r3, r3, #4
-
-LoopCopyDataInit:
-  adds r4, r0, r3
-  cmp r4, r1
-  bcc CopyDataInit
-  
-/* Zero fill the bss segment. */
-  ldr r2, =_sbss
-  ldr r4, =_ebss
-  movs r3, #0
-  b LoopFillZerobss
+/* Copy initialized sections of every bank (.data, .ram2_text, .ram2_data, .sysDiag) from flash */
+  ldr r5, =__copy_table_start__
+  ldr r6, =__copy_table_end__
+  b LoopCopyTable
+
+CopyTableEntry:
+  ldmia r5!, {r0, r1, r2}
+  bl CopySection
 
-FillZerobss:
-  str  r3, [r2]
-  adds r2, r2, #4
+LoopCopyTable:
+  cmp r5, r6
+  bcc CopyTableEntry
 
-LoopFillZerobss:
-  cmp r2, r4
-  bcc FillZerobss
+/* Zero fill sections of every bank (.bss, .ramDiagnostics) */
+  ldr r5, =__zero_table_start__
+  ldr r6, =__zero_table_end__
+  b LoopZeroTable
+
+ZeroTableEntry:
+  ldmia r5!, {r1, r2}
+  movs r3, #0
+  bl FillSection
+
+LoopZeroTable:
+  cmp r5, r6
+  bcc ZeroTableEntry
 
 /* Call static constructors */
     bl __libc_init_array
+/* Record the time to main, read by bootCritical() */
+  ldr r0, =DWT_CYCCNT
+  ldr r0, [r0]
+  ldr r1, =initialize_cyclesToMain
+  str r0, [r1]
 /* Call the application's entry point.*/
 	bl	main
 
 LoopForever:
     b LoopForever
-    
+
+/* Copy from r0 (flash) to r1 up to r2, word aligned. 16 bytes per LDM/STM burst,
+   assemble with --defsym STARTUP_WORDWISE=1 for the reference word loop. Uses r3, r4, r7, r12 */
+CopySection:
+.ifndef STARTUP_WORDWISE
+  b LoopCopyBurst
+
+CopyBurst:
+  ldmia r0!, {r3, r4, r7, r12}
+  stmia r1!, {r3, r4, r7, r12}
+
+LoopCopyBurst:
+  subs r3, r2, r1
+  cmp r3, #16
+  bhs CopyBurst
+.endif
+  b LoopCopyWord
+
+CopyWord:
+  ldr r3, [r0], #4
+  str r3, [r1], #4
+
+LoopCopyWord:
+  cmp r1, r2
+  bcc CopyWord
+  bx lr
+
+/* Fill from r1 up to r2 with r3, word aligned. 16 bytes per STM burst. Uses r0, r4, r7, r12 */
+FillSection:
+.ifndef STARTUP_WORDWISE
+  mov r4, r3
+  mov r7, r3
+  mov r12, r3
+  b LoopFillBurst
+
+FillBurst:
+  stmia r1!, {r3, r4, r7, r12}
+
+LoopFillBurst:
+  subs r0, r2, r1
+  cmp r0, #16
+  bhs FillBurst
+.endif
+  b LoopFillWord
+
+FillWord:
+  str r3, [r1], #4
+
+LoopFillWord:
+  cmp r1, r2
+  bcc FillWord
+  bx lr
+
 .size	Reset_Handler, .-Reset_Handler
 
 /**
@@ -27,6 +27,120 @@
 // Uart Handler for use in HAL
 extern UART_HandleTypeDef uart;
 
+// DMA channel handler used by uart transmitter (DMA1 Channel7, request 2)
+extern DMA_HandleTypeDef uart_dma_tx;
+
+// Size of uart transmit ring buffer in bytes (must be a power of 2)
+#define UART_TX_BUFFER_SIZE 4096
+
+// DMA channel handler used by uart receiver (DMA1 Channel6, request 2)
+extern DMA_HandleTypeDef uart_dma_rx;
+
+// Size of uart circular receive buffer in bytes
+#define UART_RX_BUFFER_SIZE 64
+
+// Maximum length of a single command line including terminator
+#define UART_RX_LINE_SIZE 32
+
+// Size of printf log ring buffer in RAM2 in bytes (must be a power of 2)
+#define LOG_BUFFER_SIZE 2048
+
+// Tokenized logging, 1 sends format string IDs and packed arguments, 0 formats text on target
+#define LOG_TOKENIZED 1
+
+// Size of tokenized log ring buffer in RAM2 in bytes (must be a power of 2)
+#define LOG_TOKEN_BUFFER_SIZE 512
+
+// Maximum length of a tokenized log line formatted on target (LOG_TOKENIZED 0)
+#define LOG_TOKEN_LINE_SIZE 64
+
+// Period of binary memory telemetry frames in ms (50 Hz)
+#define TELEMETRY_PERIOD_MS 20
+
+// Period of memory usage history samples in ms, taken in SysTick
+#define MEMHISTORY_PERIOD_MS 100
+
+// Number of memory usage history samples kept in RAM2
+#define MEMHISTORY_DEPTH 32
+
+// Cycle budget of one memory history sample, samples above it are counted
+#define MEMHISTORY_SAMPLE_CYCLES_MAX 400
+
+// Fixed-block pools X(id,blockSize,blockCount), ordered by block size, block size multiple of 8
+#define POOL_CLASSES(X) \
+    X(32,  32,  16) \
+    X(128, 128, 8) \
+    X(1024,1024,4) \
+    X(7680,7680,1)
+
+// Tasks of the main loop X(id,entry,stackSize,placement), stack size multiple of TASK_GUARD_SIZE,
+// HOT frames go to .crit in RAM2, COLD frames to .tdat in RAM1
+#define TASKS(X) \
+    X(commands, commandsProcess, 1024,COLD) \
+    X(telemetry,telemetryProcess,512, HOT) \
+    X(log,      logDrain,        512, COLD)
+
+// Clock profiles X(id,sysclkHz,source,msiRange,pllN,voltageScale,flashLatency), see TrinityTrack6000_Clock.h
+// PLL runs from HSI16 with M=1 and R=2, range 2 (SCALE2) allows 26 MHz at 3 wait states, first profile is the boot profile
+#define CLOCK_PROFILES(X) \
+    X(performance,80000000,PLL,0,             10,PWR_REGULATOR_VOLTAGE_SCALE1,FLASH_LATENCY_4) \
+    X(balanced,   24000000,MSI,RCC_MSIRANGE_9,0, PWR_REGULATOR_VOLTAGE_SCALE2,FLASH_LATENCY_3) \
+    X(lowPower,   4000000, MSI,RCC_MSIRANGE_6,0, PWR_REGULATOR_VOLTAGE_SCALE2,FLASH_LATENCY_0)
+
+// Maximum number of peripherals retimed by a clock profile switch
+#define CLOCK_CALLBACKS_MAX 4
+
+// Longest wait for the uart transmitter to drain before a clock profile switch in ms (full ring at 115200 baud)
+#define CLOCK_DRAIN_TIMEOUT_MS 400
+
+// Boot stages X(id,entry,kind), see TrinityTrack6000_Boot.h, CRITICAL stages first and in dependency order,
+// check must stay first (nothing may write RAM2 before it), DEFERRED stages run one per main loop cycle
+#define BOOT_STAGES(X) \
+    X(check,      initializeCheck,      CRITICAL) \
+    X(crash,      crashInit,            CRITICAL) \
+    X(hal,        initializeHAL,        CRITICAL) \
+    X(clock,      initializeClock,      CRITICAL) \
+    X(gpio,       initializeGPIO,       CRITICAL) \
+    X(uart,       initializeUART,       CRITICAL) \
+    X(memory,     initializeMemory,     CRITICAL) \
+    X(idle,       idleInit,             CRITICAL) \
+    X(diagnostics,initializeDiagnostics,DEFERRED) \
+    X(banner,     initializeBanner,     DEFERRED) \
+    X(reports,    initializeReports,    DEFERRED) \
+    X(benchmarks, initializeBenchmarks, DEFERRED) \
+    X(fpu,        initializeFpuBench,   DEFERRED)
+
+// Consecutive warm restarts, the next Error_Handler() halts instead of resetting (fault on every boot)
+#define CRASH_RESTARTS_MAX 3
+
+// Main loop cycles without a crash after which the restart count is cleared (1 s)
+#define CRASH_STABLE_CYCLES (1000/MAIN_LOOP_PERIOD_MS)
+
+// Tickless idle between main loop cycles, see TrinityTrack6000_Idle.h. Stop 2 loses USART2 input (not a Stop 2
+// wakeup source), off keeps the idle in Sleep
+#ifndef IDLE_STOP2_ENABLED
+    #define IDLE_STOP2_ENABLED 0
+#endif
+
+// Shortest idle window in ms spent in Stop 2, shorter ones stay in Sleep
+#define IDLE_STOP2_MIN_MS 5
+
+// Time from reset to the end of the first main loop cycle in us, a longer boot is reported as OVER
+#define BOOT_FIRST_CYCLE_BUDGET_US 20000
+
+// newlib heap (_sbrk), off keeps the memory 100% static and the linker rejects anything pulling _sbrk in
+#ifndef NEWLIB_HEAP_ENABLED
+    #define NEWLIB_HEAP_ENABLED 0
+#endif
+
+// Period of main loop in ms
+#define MAIN_LOOP_PERIOD_MS 10
+
+// Interrupt priorities of the uart transmit and receive paths
+#define UART_TX_DMA_IRQ_PRIORITY 6
+#define UART_RX_DMA_IRQ_PRIORITY 6
+#define UART_IRQ_PRIORITY        6
+
 
 	
 #endif // _TRINITY_TRACK6000_CONFIG_H_
\ No newline at end of file
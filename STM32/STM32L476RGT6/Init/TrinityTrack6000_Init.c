@@ -1,62 +1,74 @@
-#include <string.h>
-
 #include <TrinityTrack6000_Init.h>
 #include <TrinityTrack6000_Errors.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_UartRx.h>
+#include <TrinityTrack6000_Log.h>
+#include <TrinityTrack6000_MemHistory.h>
+#include <TrinityTrack6000_MemTrace.h>
+#include <TrinityTrack6000_Pool.h>
+#include <TrinityTrack6000_Task.h>
+#include <TrinityTrack6000_Crash.h>
+#include <TrinityTrack6000_Placement.h>
+#include <TrinityTrack6000_Clock.h>
+#include <TrinityTrack6000_Boot.h>
+#include <TrinityTrack6000_MemInfo.h>
+#include <TrinityTrack6000_RamBench.h>
+#include <TrinityTrack6000_Bench.h>
+#include <TrinityTrack6000_FpuBench.h>
 
 extern void ramDiagnositcsInit(void);
 
-const char msg_initializeHAL_info[]   ="| 00 HAL Initialized\r\n";
-const char msg_initializeClock_info[] ="| 01 Clock Initialized\r\n";
-const char msg_initializeGPIO_info[]  ="| 02 GPIO Initialized\r\n";
-const char msg_initializeUART_info[]  ="| 03 UART Initialized\r\n";
-const char msg_initializeRAMDia_info[]="| 04 Memory diagnostics Initialized\r\n";
+extern uint32_t __RAM_DIAGNOSTICS_START__; // Defined in the linker script
+extern uint32_t __RAM_DIAGNOSTICS_END__;
+
+uint32_t initialize_cyclesToMain;
+uint32_t initialize_ram2Sentinel RAM2_SYSDIAG(initialize_ram2Sentinel)=INITIALIZE_RAM2_SENTINEL;
+
+static uint32_t initialize_ram2Wrong; // Result of initializeCheck(), reported by the banner
+
+// Counts RAM2 words not at their declared value, .sysDiag is copied and .ramDiagnostics zeroed by startup
+static uint32_t initializeCheckRam2(void){
+	uint32_t wrong=(initialize_ram2Sentinel!=INITIALIZE_RAM2_SENTINEL)+(global_error_code!=0);
+
+	for(const uint32_t*word=&__RAM_DIAGNOSTICS_START__;word<&__RAM_DIAGNOSTICS_END__;word++){
+		wrong+=(*word!=0);
+	}
+	return wrong;
+}
+
+// Keeps the baud rate over clock profile switches, USART2 runs from PCLK1
+static void initializeUARTClock(ClockPhase phase){
+	uint32_t start;
+
+	if(phase==CLOCK_PHASE_PREPARE){
+		start=HAL_GetTick();
+		while(!uartTxIsIdle()||!__HAL_UART_GET_FLAG(&uart,UART_FLAG_TC)){
+			if(HAL_GetTick()-start>=CLOCK_DRAIN_TIMEOUT_MS){
+				clock_drainTimeouts++;
+				break;
+			}
+		}
+		return;
+	}
+	// BRR is writable only with the USART disabled
+	__HAL_UART_DISABLE(&uart);
+	uart.Instance->BRR=UART_DIV_SAMPLING16(HAL_RCC_GetPCLK1Freq(),uart.Init.BaudRate);
+	__HAL_UART_ENABLE(&uart);
+}
+
+void initializeCheck(void){
+	if(crashPending()){ // Warm boot, skipped to shorten the restart
+		return;
+	}
+	initialize_ram2Wrong=initializeCheckRam2();
+}
 
 void initializeHAL(void){
 	HAL_Init();
 }
 
 void initializeClock(void){
-  	RCC_OscInitTypeDef RCC_OscInitStruct={0};
-  	RCC_ClkInitTypeDef RCC_ClkInitStruct={0};
-
-  	/** Configure the main internal regulator output voltage
-  	*/
-  	if(HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE1)!=HAL_OK){
-		global_error_code=ERROR_HAL_PWREx_ControlVoltageScaling;
-    	Error_Handler();
-  	}
-
-  	/** Initializes the RCC Oscillators according to the specified parameters
-  	* in the RCC_OscInitTypeDef structure.
-  	*/
-  	RCC_OscInitStruct.OscillatorType=RCC_OSCILLATORTYPE_HSI;
-  	RCC_OscInitStruct.HSIState=RCC_HSI_ON;
-  	RCC_OscInitStruct.HSICalibrationValue=RCC_HSICALIBRATION_DEFAULT;
-  	RCC_OscInitStruct.PLL.PLLState=RCC_PLL_ON;
-  	RCC_OscInitStruct.PLL.PLLSource=RCC_PLLSOURCE_HSI;
-  	RCC_OscInitStruct.PLL.PLLM=1;
-  	RCC_OscInitStruct.PLL.PLLN=10;
-  	RCC_OscInitStruct.PLL.PLLP=RCC_PLLP_DIV7;
-  	RCC_OscInitStruct.PLL.PLLQ=RCC_PLLQ_DIV2;
-  	RCC_OscInitStruct.PLL.PLLR=RCC_PLLR_DIV2;
-  	if(HAL_RCC_OscConfig(&RCC_OscInitStruct)!=HAL_OK){
-		global_error_code=ERROR_HAL_RCC_OscConfig;
-    	Error_Handler();
-  	}
-
-  	/** Initializes the CPU, AHB and APB buses clocks
-  	*/
-  	RCC_ClkInitStruct.ClockType=RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK
-                              |RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2;
-  	RCC_ClkInitStruct.SYSCLKSource=RCC_SYSCLKSOURCE_PLLCLK;
-  	RCC_ClkInitStruct.AHBCLKDivider=RCC_SYSCLK_DIV1;
-  	RCC_ClkInitStruct.APB1CLKDivider=RCC_HCLK_DIV1;
-  	RCC_ClkInitStruct.APB2CLKDivider=RCC_HCLK_DIV1;
-
-  	if(HAL_RCC_ClockConfig(&RCC_ClkInitStruct,FLASH_LATENCY_4)!=HAL_OK){
-		global_error_code=ERROR_HAL_RCC_ClockConfig;
-    	Error_Handler();
-  	}	
+	clockSwitch(0); // Boot profile, first entry of CLOCK_PROFILES
 }
 
 void initializeGPIO(void){
@@ -84,31 +96,69 @@ void initializeUART(void){
 		global_error_code=ERROR_HAL_UART_Init;
 		Error_Handler();
 	}
-	// Fix magic numbers
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_initializeHAL_info,strlen(msg_initializeHAL_info),1000);
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_initializeClock_info,strlen(msg_initializeClock_info),1000);
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_initializeGPIO_info,strlen(msg_initializeGPIO_info),1000);
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_initializeUART_info,strlen(msg_initializeUART_info),1000);
+	uartTxInit();
+	uartRxInit();
+	logInit();
+	if(clockRegister(initializeUARTClock)!=HAL_OK){
+		global_error_code=ERROR_CLOCK_CALLBACKS;
+		Error_Handler();
+	}
 }
 
 void initializeMemory(void){
+	poolInit();
+	taskInit();
+	memTraceInit(); // Before the first allocation
+}
+
+void initializeDiagnostics(void){
 	ramDiagnositcsInit();
+	memHistoryInit();
+}
+
+void initializeBanner(void){
+	LOG_TOKEN("| 00 HAL Initialized\r\n");
+	LOG_TOKEN("| 01 Clock Initialized, SYSCLK %lu Hz, switched in %lu us\r\n",HAL_RCC_GetSysClockFreq(),clock_switchMicrosLast);
+	LOG_TOKEN("| 02 GPIO Initialized\r\n");
+	LOG_TOKEN("| 03 UART Initialized, %lu baud\r\n",uart.Init.BaudRate);
+	LOG_TOKEN("| 04 Memory diagnostics Initialized, history every %u ms\r\n",MEMHISTORY_PERIOD_MS);
+	LOG_TOKEN("| 05 Startup %lu cycles to main, RAM2 words not initialized %lu\r\n",initialize_cyclesToMain,initialize_ram2Wrong);
+	LOG_TOKEN("| 06 First control cycle at %lu us\r\n",boot_firstCycleMicros);
+	crashReport();
+}
+
+void initializeReports(void){
+	if(crash_warmBoot){ // Boot reports and benchmarks are skipped when restarting after a crash
+		return;
+	}
+	ramDiagnosticsRefresh();
+	ramDiagnosticsGeneral();
+	ramDiagnosticsRAM1();
+	ramDiagnosticsRAM2();
+}
 
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_initializeRAMDia_info,strlen(msg_initializeRAMDia_info),1000);
+void initializeBenchmarks(void){
+	if(crash_warmBoot){
+		return;
+	}
+	benchRunAll(); // Kernels registered with BENCH(), see TrinityTrack6000_BenchKernels.c
+	ramBenchRun();
+}
+
+void initializeFpuBench(void){
+	if(crash_warmBoot){
+		return;
+	}
+	fpuBenchRun(); // Own stage, starts once the output of the other benchmarks has drained
 }
 
 void initializeSystem(void){
-	initializeHAL();
-	initializeClock();
-	initializeGPIO();
-	initializeUART();
-	initializeMemory();
+	bootCritical();
 }
 
 void Error_Handler(void){
+	uint32_t start=DWT->CYCCNT;
+
 	__disable_irq();
-	while(1){
-		// Debug Loop
-		// In the future restart of the system
-	}
+	crashRestart(start); // Record survives the reset in .noinit, see TrinityTrack6000_Crash.h
 }
\ No newline at end of file
@@ -6,6 +6,10 @@
  * system clock, HAL, GPIO, UART, and the overall system setup.  
  * It also defines error handling and assert reporting mechanisms.
  *
+ * Every routine is a boot stage of `BOOT_STAGES` in TrinityTrack6000_Config.h,
+ * critical ones run from `initializeSystem()`, deferred ones from the main
+ * loop (see TrinityTrack6000_Boot.h).
+ *
  * @date 2025.09.08
  * @author Alan Kudełko
  */
@@ -14,22 +18,35 @@
 	#define _TRINITY_TRACK6000_INIT_H_
 
 #include <TrinityTrack6000_Config.h>
+#include <TrinityTrack6000_Placement.h>
 
-/** @name Bootup sequence diagnostics strings
- *  @{
- */
+/* Bootup sequence diagnostics are tokenized, strings are kept in .logStrings (see TrinityTrack6000_Log.h) */
+
+#define INITIALIZE_RAM2_SENTINEL 0x5EED0A11u /**< Declared value of initialize_ram2Sentinel, checked at boot */
 
-extern const char msg_initializeHAL_info[]; /**< Info1 */
-extern const char msg_initializeClock_info[]; /**< Info1 */
-extern const char msg_initializeGPIO_info[]; /**< Info1 */
-extern const char msg_initializeUART_info[]; /**< Info1 */
-extern const char msg_initializeRAMDia_info[]; /**< Info1 */
+/**
+ * @brief Startup diagnostics
+ * @{
+ */
+extern uint32_t initialize_cyclesToMain; /**< Cycles from the first Reset_Handler instruction to main(), stored by startup */
+extern uint32_t initialize_ram2Sentinel RAM2_SYSDIAG(initialize_ram2Sentinel); /**< Proves the copy table reached RAM2 */
 /** @} */
 
 #ifdef __cplusplus
 	extern "C"{
 #endif // __cplusplus
 
+/**
+  * @brief Startup Check Function
+  *
+  * Checks that RAM2 sections start at their declared values (copy and zero
+  * tables of the linker script), first stage, before anything writes RAM2.
+  * Skipped on a warm boot.
+  * @param None
+  * @retval None
+  */
+void initializeCheck(void);
+
 /**
   * @brief HAL Initialization Function
   * @param None
@@ -39,6 +56,9 @@ void initializeHAL(void);
 
 /**
   * @brief System Clock Configuration
+  *
+  * Applies the boot clock profile, first entry of `CLOCK_PROFILES`
+  * (see TrinityTrack6000_Clock.h).
   * @retval None
   */
 void initializeClock(void);
@@ -59,13 +79,55 @@ void initializeUART(void);
 
 /**
   * @brief Memory Initialization Function
+  *
+  * Pools, task frames and the allocation tracer, the main loop needs them.
   * @param None
   * @retval None
   */
 void initializeMemory(void);
 
+/**
+  * @brief Memory Diagnostics Initialization Function, deferred
+  * @param None
+  * @retval None
+  */
+void initializeDiagnostics(void);
+
+/**
+  * @brief Boot Banner Function, deferred
+  *
+  * Logs the initialization steps, the startup time to main and the RAM2
+  * check, then the crash record of a warm boot.
+  * @param None
+  * @retval None
+  */
+void initializeBanner(void);
+
+/**
+  * @brief Boot Memory Reports Function, deferred, skipped on a warm boot
+  * @param None
+  * @retval None
+  */
+void initializeReports(void);
+
+/**
+  * @brief Boot Benchmarks Function, deferred, skipped on a warm boot
+  * @param None
+  * @retval None
+  */
+void initializeBenchmarks(void);
+
+/**
+  * @brief Boot FPU/ALU Kernel Benchmark Function, deferred, skipped on a warm boot
+  * @param None
+  * @retval None
+  */
+void initializeFpuBench(void);
+
 /**
  * @brief System Initialization Function
+ *
+ * Runs the critical boot stages, see `bootCritical()`.
  * @param None
  * @retval None
  */
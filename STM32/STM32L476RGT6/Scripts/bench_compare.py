@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Compares TrinityTrack6000 micro-benchmark captures.
+
+Every kernel registered with BENCH() prints one line (see
+Utils/TrinityTrack6000_Bench.h), on the target in cycles, on the host
+(Scripts/bench_host.c) in nanoseconds:
+
+    BENCH div_f32 cyc n=63 min=14 med=14 max=15 mean=14.03 sd=0.17 ovh=9
+
+Other lines of a capture (boot log, tables) are skipped. The first capture
+is the reference, every other one is printed next to it with the ratio of
+medians. A target capture in cycles is converted to nanoseconds with --mhz.
+
+    ./bench_compare.py host.txt target.txt --mhz 80
+"""
+import argparse
+import re
+import sys
+
+LINE = re.compile(r"BENCH (\S+) (cyc|ns) ((?:\w+=[\d.]+ ?)+)")
+
+
+def load(path, mhz):
+    results = {}
+    with open(path, "rb") as capture:
+        for raw in capture:
+            match = LINE.search(raw.decode("utf-8", "replace"))
+            if match is None:
+                continue
+            name, unit, fields = match.groups()
+            values = {key: float(value) for key, value in (field.split("=") for field in fields.split())}
+            if unit == "cyc" and mhz:
+                values = {key: (value if key == "n" else value * 1000.0 / mhz) for key, value in values.items()}
+                unit = "ns"
+            results[name] = (unit, values)
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("captures", nargs="+", help="captured output, first one is the reference")
+    parser.add_argument("--mhz", type=float, help="core clock of target captures, converts cycles to ns")
+    args = parser.parse_args()
+
+    runs = [load(path, args.mhz) for path in args.captures]
+    names = []
+    for run in runs:
+        names += [name for name in run if name not in names]
+    if not names:
+        print("No BENCH lines found")
+        return 1
+
+    header = "%-14s" % "Kernel" + "".join("| %-26s" % path[-26:] for path in args.captures)
+    print(header)
+    print("-" * len(header))
+    reference = runs[0]
+    for name in names:
+        row = "%-14s" % name
+        for index, run in enumerate(runs):
+            if name not in run:
+                row += "| %-26s" % "-"
+                continue
+            unit, values = run[name]
+            cell = "%.1f %s sd %.1f" % (values["med"], unit, values["sd"])
+            if index > 0 and name in reference and reference[name][0] == unit and reference[name][1]["med"] > 0:
+                cell += " x%.2f" % (values["med"] / reference[name][1]["med"])
+            row += "| %-26s" % cell
+        print(row)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,21 @@
+/**
+ * @file bench_host.c
+ * @brief Host runner of the micro-benchmark harness.
+ *
+ * Runs every kernel registered with `BENCH()` on the host and prints the
+ * same lines as the target, in nanoseconds, see TrinityTrack6000_Bench.h.
+ *
+ *     gcc -O2 -DBENCH_HOST -IUtils Scripts/bench_host.c Utils/TrinityTrack6000_Bench.c \
+ *         Utils/TrinityTrack6000_BenchKernels.c Utils/TrinityTrack6000_Format.c -o bench_host
+ *     ./bench_host > host.txt
+ *     ./Scripts/bench_compare.py host.txt target.txt
+ *
+ * @date 2025.09.25
+ * @author Alan Kudełko
+ */
+#include <TrinityTrack6000_Bench.h>
+
+int main(void){
+	benchRunAll();
+	return 0;
+}
@@ -0,0 +1,84 @@
+"""Minimal reader of little endian ELF32 files produced by arm-none-eabi-gcc.
+
+Only what the TrinityTrack6000 host tools need: section headers, section
+contents and the symbol table. No dependencies outside the standard library.
+"""
+import struct
+from collections import namedtuple
+
+Section = namedtuple("Section", "name type flags address offset size align")
+Symbol = namedtuple("Symbol", "name value size type bind section")
+
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+SHF_EXECINSTR = 0x4
+
+STT_OBJECT = 1
+STT_FUNC = 2
+
+
+class ElfError(Exception):
+    pass
+
+
+class Elf32:
+    def __init__(self, path):
+        with open(path, "rb") as file:
+            self.data = file.read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1 or self.data[5] != 1:
+            raise ElfError("%s is not a little endian ELF32 file" % path)
+
+        (shoff,) = struct.unpack_from("<I", self.data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x2E)
+        raw = [struct.unpack_from("<IIIIIIIIII", self.data, shoff + i * shentsize) for i in range(shnum)]
+        names = raw[shstrndx][4]
+
+        self.sections = []
+        for name, sh_type, flags, address, offset, size, _, _, align, _ in raw:
+            self.sections.append(Section(self._string(names + name), sh_type, flags, address, offset, size, align))
+        self._raw = raw
+        self._symbols = None
+
+    def _string(self, offset):
+        return self.data[offset:self.data.index(b"\x00", offset)].decode("utf-8", "replace")
+
+    def section(self, name):
+        for section in self.sections:
+            if section.name == name:
+                return section
+        return None
+
+    def contents(self, section):
+        if section.type == SHT_NOBITS:
+            return bytes(section.size)
+        return self.data[section.offset:section.offset + section.size]
+
+    def symbols(self):
+        if self._symbols is None:
+            self._symbols = []
+            for index, section in enumerate(self.sections):
+                if section.type != SHT_SYMTAB:
+                    continue
+                strings = self.sections[self._raw[index][6]].offset
+                for offset in range(section.offset + 16, section.offset + section.size, 16):
+                    name, value, size, info, _, shndx = struct.unpack_from("<IIIBBH", self.data, offset)
+                    self._symbols.append(Symbol(self._string(strings + name), value, size, info & 0x0F, info >> 4, shndx))
+        return self._symbols
+
+    def symbol(self, name):
+        for symbol in self.symbols():
+            if symbol.name == name:
+                return symbol
+        return None
+
+    def function_at(self, address):
+        """Returns (name, offset) of the function containing address or None."""
+        address &= ~1  # Thumb bit
+        for symbol in self.symbols():
+            start = symbol.value & ~1
+            if symbol.type == STT_FUNC and start <= address < start + max(symbol.size, 1):
+                return symbol.name, address - start
+        return None
@@ -0,0 +1,109 @@
+/**
+ * @file format_bench.c
+ * @brief Host benchmark of formatString() against newlib/glibc snprintf().
+ *
+ * Renders the RAM diagnostics table lines with both formatters and reports
+ * time per line, stack depth (measured on a painted stack) and checks that
+ * both produce identical text.
+ *
+ *     gcc -O2 -IUtils Scripts/format_bench.c Utils/TrinityTrack6000_Format.c -o format_bench
+ *     ./format_bench
+ *
+ * Flash cost has to be taken from the target map file, compare
+ * `arm-none-eabi-size` of the firmware with and without `_vfprintf_r`.
+ *
+ * @date 2025.09.14
+ * @author Alan Kudełko
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include <TrinityTrack6000_Format.h>
+
+#define BENCH_ITERATIONS 200000
+#define BENCH_STACK_SIZE 16384
+#define BENCH_LINE_SIZE  90
+
+// Same templates as in TrinityTrack6000_MemInfo.c, uint32_t is unsigned int on host
+static const char bench_formatRAM1[]="│ RAM1   │ 0x%08X │ 0x%08X │ %3u  KB │%11s │ %3u%%       │\r\n";
+static const char bench_formatData[]="| .DATA   | 0x%08X | 0x%08X | %3u  KB | %3u  KB   |            |\r\n";
+
+static char bench_line[BENCH_LINE_SIZE];
+static volatile uint32_t bench_sink;
+static int bench_useSnprintf;
+
+static void benchRenderLines(void){
+	char bar[11];
+	int length;
+
+	formatBar(bar,40,10);
+	bar[10]='\0';
+	if(bench_useSnprintf){
+		length=snprintf(bench_line,BENCH_LINE_SIZE,bench_formatRAM1,0x20000000u,0x20017FFFu,96u,bar,40u);
+		length+=snprintf(bench_line,BENCH_LINE_SIZE,bench_formatData,0x20000000u,0x20000A10u,2u,2u);
+	}
+	else{
+		length=formatString(bench_line,BENCH_LINE_SIZE,bench_formatRAM1,0x20000000u,0x20017FFFu,96u,bar,40u);
+		length+=formatString(bench_line,BENCH_LINE_SIZE,bench_formatData,0x20000000u,0x20000A10u,2u,2u);
+	}
+	bench_sink+=(uint32_t)length;
+}
+
+static double benchNanosecondsPerLine(void){
+	struct timespec start,end;
+
+	clock_gettime(CLOCK_MONOTONIC,&start);
+	for(uint32_t i=0;i<BENCH_ITERATIONS;i++){
+		benchRenderLines();
+	}
+	clock_gettime(CLOCK_MONOTONIC,&end);
+
+	return ((end.tv_sec-start.tv_sec)*1e9+(end.tv_nsec-start.tv_nsec))/(BENCH_ITERATIONS*2.0);
+}
+
+static uint8_t bench_stack[BENCH_STACK_SIZE];
+static ucontext_t bench_mainContext,bench_taskContext;
+
+// Runs one render on a painted stack, returns number of bytes touched
+static uint32_t benchStackDepth(void){
+	uint32_t unused=0;
+
+	memset(bench_stack,0xA5,sizeof(bench_stack));
+	getcontext(&bench_taskContext);
+	bench_taskContext.uc_stack.ss_sp=bench_stack;
+	bench_taskContext.uc_stack.ss_size=sizeof(bench_stack);
+	bench_taskContext.uc_link=&bench_mainContext;
+	makecontext(&bench_taskContext,benchRenderLines,0);
+	swapcontext(&bench_mainContext,&bench_taskContext);
+
+	while(unused<sizeof(bench_stack)&&bench_stack[unused]==0xA5){
+		unused++;
+	}
+	return sizeof(bench_stack)-unused;
+}
+
+int main(void){
+	char reference[BENCH_LINE_SIZE];
+	const char*names[]={"formatString","snprintf"};
+	uint32_t stack[2];
+	double time[2];
+
+	for(bench_useSnprintf=0;bench_useSnprintf<2;bench_useSnprintf++){
+		stack[bench_useSnprintf]=benchStackDepth();
+		time[bench_useSnprintf]=benchNanosecondsPerLine();
+		if(bench_useSnprintf==0){
+			memcpy(reference,bench_line,sizeof(reference));
+		}
+	}
+	if(strcmp(reference,bench_line)!=0){
+		printf("Output differs:\n%s%s",reference,bench_line);
+		return 1;
+	}
+	for(int i=0;i<2;i++){
+		printf("%-12s %7.1f ns/line  stack %5u B\n",names[i],time[i],stack[i]);
+	}
+	return 0;
+}
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""Decoder for TrinityTrack6000 tokenized log messages.
+
+LOG_TOKEN() sends a 16 bit token and packed 32 bit arguments in a telemetry
+frame (see Utils/TrinityTrack6000_Log.h). The token is the offset of the
+format string in the `.logStrings` section of the firmware ELF file, which
+is never loaded to the target.
+
+    stty -F /dev/ttyACM0 115200 raw -echo
+    ./log_decode.py build/Debug/STM32L476RGT6.elf /dev/ttyACM0
+    ./log_decode.py build/Debug/STM32L476RGT6.elf capture.bin --list
+
+Plain text between frames (ASCII tables, printf) is passed through.
+"""
+import argparse
+import re
+import struct
+import sys
+
+from elf32 import Elf32
+from telemetry_decode import FRAME_LOG, FrameError, decode_frame
+
+FRAME_SEARCH = 325  # Longest encoded frame, TELEMETRY_FRAME_SIZE
+CONVERSION = re.compile(r"%[-0]*\d*l*([udixXc%])")
+
+
+def load_strings(path):
+    elf = Elf32(path)
+    section = elf.section(".logStrings")
+    if section is None:
+        raise SystemExit("%s has no .logStrings section" % path)
+    return elf.contents(section)
+
+
+def format_message(strings, token, arguments):
+    if token >= len(strings):
+        return "<unknown token 0x%04X%s>\r\n" % (token, "".join(" 0x%X" % a for a in arguments))
+    end = strings.index(b"\x00", token)
+    template = strings[token:end].decode("utf-8", "replace")
+
+    # Arguments travel as uint32_t, restore sign for %d like the target would
+    signed = [c in "di" for c in CONVERSION.findall(template) if c != "%"]
+    values = [(a - (1 << 32)) if s and a & 0x80000000 else a for a, s in zip(arguments, signed)]
+    try:
+        return CONVERSION.sub(lambda m: m.group(0).replace("l", ""), template) % tuple(values)
+    except (TypeError, ValueError):
+        return "<format mismatch %r %s>\r\n" % (template, arguments)
+
+
+def split_text(data):
+    """Splits text output preceding a frame, returns (text, decoded frame or None)."""
+    for start in range(max(0, len(data) - FRAME_SEARCH), len(data)):
+        try:
+            return data[:start], decode_frame(data[start:])
+        except FrameError:
+            continue
+    return data, None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="firmware ELF file, e.g. build/Debug/STM32L476RGT6.elf")
+    parser.add_argument("source", nargs="?", help="serial device or capture file, '-' for stdin")
+    parser.add_argument("--list", action="store_true", help="print token table and exit")
+    args = parser.parse_args()
+
+    strings = load_strings(args.elf)
+    if args.list or args.source is None:
+        token = 0
+        while token < len(strings):
+            end = strings.index(b"\x00", token)
+            if end > token:
+                print("0x%04X %r" % (token, strings[token:end].decode("utf-8", "replace")))
+            token = end + 1
+        return 0
+
+    stream = sys.stdin.buffer if args.source == "-" else open(args.source, "rb", buffering=0)
+    out = sys.stdout
+    pending = bytearray()
+    while True:
+        chunk = stream.read(1) if stream.isatty() else stream.read(256)
+        if not chunk:
+            return 0
+        pending += chunk
+        while True:
+            end = pending.find(b"\x00")
+            if end < 0:
+                break
+            frame = bytes(pending[:end])
+            del pending[:end + 1]
+            text, decoded = split_text(frame)
+            out.write(text.decode("utf-8", "replace"))
+            if decoded is None:
+                continue
+            frame_type, _, records = decoded
+            if frame_type != FRAME_LOG or len(records) < 2 or (len(records) - 2) % 4:
+                continue
+            token, = struct.unpack_from("<H", records)
+            arguments = struct.unpack_from("<%dI" % ((len(records) - 2) // 4), records, 2)
+            out.write(format_message(strings, token, arguments))
+        out.flush()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,120 @@
+/**
+ * @file message_bench.c
+ * @brief Host benchmark of constant messages sent with strlen() and with Message lengths.
+ *
+ * Sends the constant lines of one full memory report (RAM DIAGNOSTICS
+ * table and the RAM1 and RAM2 bank tables, as in TrinityTrack6000_MemInfo.c)
+ * into a copy of the transmit ring, once taking each length from `strlen()`
+ * and once from `MESSAGE_DEFINE()`, and reports the time per report and
+ * the difference. Formatted lines are the same for both and left out.
+ *
+ *     gcc -O2 -IUtils Scripts/message_bench.c -o message_bench
+ *     ./message_bench
+ *
+ * @date 2025.09.27
+ * @author Alan Kudełko
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <TrinityTrack6000_Message.h>
+
+#define BENCH_ITERATIONS  200000
+#define BENCH_RING_SIZE   4096
+#define BENCH_RING_MASK   (BENCH_RING_SIZE-1)
+
+// Same texts as in TrinityTrack6000_MemInfo.c
+MESSAGE_DEFINE(msg_generalHeader1,"+-------------------------[ RAM DIAGNOSTICS ]--------------------------+\r\n");
+MESSAGE_DEFINE(msg_generalHeader2,"| Bank   | Start      | End        | Size [B] | Usage      | Used      |\r\n");
+MESSAGE_DEFINE(msg_generalHeader3,"+--------+------------+------------+----------+------------+-----------+\r\n");
+MESSAGE_DEFINE(msg_generalFooter1,"| s(snap) b(bank) h(hist) a(alloc) k(tasks) c(clock) t(telem) q(quit)  |\r\n");
+MESSAGE_DEFINE(msg_generalFooter2,"+----------------------------------------------------------------------+\r\n");
+MESSAGE_DEFINE(msg_bankHeader2,   "| Section | Start      | End        |  Size [B] |  Used [B] | Usage    |\r\n");
+MESSAGE_DEFINE(msg_bankHeader3,   "+---------+------------+------------+-----------+-----------+----------+\r\n");
+
+// Constant messages of one full report, in the order they are sent
+static const Message*const bench_report[]={
+	&msg_generalHeader1,&msg_generalHeader2,&msg_generalHeader3,&msg_generalHeader3,&msg_generalFooter1,&msg_generalFooter2,
+	&msg_bankHeader2,&msg_bankHeader3,&msg_bankHeader3,&msg_generalFooter1,&msg_generalFooter2, // RAM1
+	&msg_bankHeader2,&msg_bankHeader3,&msg_bankHeader3,&msg_generalFooter1,&msg_generalFooter2  // RAM2
+};
+
+#define BENCH_REPORT_LINES (sizeof(bench_report)/sizeof(bench_report[0]))
+
+static uint8_t bench_ring[BENCH_RING_SIZE];
+static uint32_t bench_head;
+static int bench_useStrlen;
+
+// Copy into the ring as uartTxWrite() does, the transmitter is always drained
+__attribute__((noinline)) static void benchWrite(const uint8_t*data,uint16_t length){
+	uint32_t offset=bench_head&BENCH_RING_MASK;
+	uint32_t firstPart=BENCH_RING_SIZE-offset;
+
+	if(firstPart>length){
+		firstPart=length;
+	}
+	memcpy(&bench_ring[offset],data,firstPart);
+	memcpy(bench_ring,data+firstPart,length-firstPart);
+	bench_head+=length;
+}
+
+__attribute__((noinline)) static void benchSendReport(const Message*const*report){
+	for(uint8_t i=0;i<BENCH_REPORT_LINES;i++){
+		const Message*message=report[i];
+
+		__asm volatile("" : "+r"(message)); // Keeps strlen() of the literal from being folded
+		if(bench_useStrlen){
+			benchWrite((const uint8_t*)message->text,(uint16_t)strlen(message->text));
+		}
+		else{
+			benchWrite((const uint8_t*)message->text,message->length);
+		}
+	}
+}
+
+static double benchNanosecondsPerReport(void){
+	struct timespec start,end;
+
+	clock_gettime(CLOCK_MONOTONIC,&start);
+	for(uint32_t i=0;i<BENCH_ITERATIONS;i++){
+		benchSendReport(bench_report);
+	}
+	clock_gettime(CLOCK_MONOTONIC,&end);
+
+	return ((end.tv_sec-start.tv_sec)*1e9+(end.tv_nsec-start.tv_nsec))/BENCH_ITERATIONS;
+}
+
+int main(void){
+	uint32_t bytes=0;
+	uint32_t headStrlen;
+	double strlenTime;
+	double messageTime;
+
+	for(uint8_t i=0;i<BENCH_REPORT_LINES;i++){
+		bytes+=bench_report[i]->length;
+		if(bench_report[i]->length!=strlen(bench_report[i]->text)){
+			printf("Length mismatch in line %u\n",i);
+			return 1;
+		}
+	}
+
+	bench_useStrlen=1;
+	bench_head=0;
+	strlenTime=benchNanosecondsPerReport();
+	headStrlen=bench_head;
+	bench_useStrlen=0;
+	bench_head=0;
+	messageTime=benchNanosecondsPerReport();
+	if(headStrlen!=bench_head){
+		printf("Sent byte counts differ\n");
+		return 1;
+	}
+
+	printf("Report: %u constant lines, %lu bytes scanned by strlen()\n",(unsigned)BENCH_REPORT_LINES,(unsigned long)bytes);
+	printf("strlen():        %8.1f ns per report\n",strlenTime);
+	printf("Message length:  %8.1f ns per report\n",messageTime);
+	printf("Saved:           %8.1f ns per report (%.1f%%)\n",strlenTime-messageTime,100.0*(strlenTime-messageTime)/strlenTime);
+	return 0;
+}
@@ -0,0 +1,35 @@
+/**
+ * @file core_cm4.h
+ * @brief Host stand-in of the CMSIS core header for the ring buffer tests.
+ *
+ * DWT and CoreDebug are plain structures, the barrier is a compiler barrier.
+ *
+ * @date 2025.09.27
+ * @author Alan Kudełko
+ */
+#ifndef _MOCK_CORE_CM4_H_
+    #define _MOCK_CORE_CM4_H_
+
+#include <stdint.h>
+
+typedef struct{
+    uint32_t CTRL;
+    uint32_t CYCCNT;
+}DWT_Type;
+
+typedef struct{
+    uint32_t DEMCR;
+}CoreDebug_Type;
+
+extern DWT_Type mock_dwt;
+extern CoreDebug_Type mock_coreDebug;
+
+#define DWT       (&mock_dwt)
+#define CoreDebug (&mock_coreDebug)
+
+#define DWT_CTRL_CYCCNTENA_Msk        (1UL<<0)
+#define CoreDebug_DEMCR_TRCENA_Msk    (1UL<<24)
+
+#define __DMB() __asm volatile("" : : : "memory")
+
+#endif // _MOCK_CORE_CM4_H_
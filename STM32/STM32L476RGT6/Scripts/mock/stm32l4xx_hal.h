@@ -0,0 +1,43 @@
+/**
+ * @file stm32l4xx_hal.h
+ * @brief Host stand-in of the STM32L4 HAL for the ring buffer tests.
+ *
+ * Shadows the HAL when `Scripts/mock` comes first on the include path.
+ * Declares only what TrinityTrack6000_UartTx.c and TrinityTrack6000_Config.h
+ * use, the peripheral itself is the test program: it defines `uart`,
+ * `HAL_UART_Transmit_DMA()`, `mock_cycles` and counts the critical sections.
+ *
+ * @date 2025.09.27
+ * @author Alan Kudełko
+ */
+#ifndef _MOCK_STM32L4XX_HAL_H_
+    #define _MOCK_STM32L4XX_HAL_H_
+
+#include <stdint.h>
+
+typedef enum{
+    HAL_OK      = 0x00,
+    HAL_ERROR   = 0x01,
+    HAL_BUSY    = 0x02,
+    HAL_TIMEOUT = 0x03
+}HAL_StatusTypeDef;
+
+typedef struct{
+    uint32_t instance; /**< Unused */
+}UART_HandleTypeDef;
+
+typedef struct{
+    uint32_t instance; /**< Unused */
+}DMA_HandleTypeDef;
+
+extern uint32_t mock_cycles;          /**< UART_TX_CYCLES(), advanced by the test */
+extern uint32_t mock_criticalDepth;   /**< Current critical section nesting */
+extern uint32_t mock_criticalEntries; /**< Critical sections entered */
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef*huart,const uint8_t*data,uint16_t size);
+
+#define UART_TX_CYCLES()         (mock_cycles++)
+#define UART_TX_ENTER_CRITICAL() mock_criticalDepth++;mock_criticalEntries++
+#define UART_TX_EXIT_CRITICAL()  mock_criticalDepth--
+
+#endif // _MOCK_STM32L4XX_HAL_H_
@@ -0,0 +1,387 @@
+#!/usr/bin/env python3
+"""Memory budget report of the TrinityTrack6000 firmware.
+
+Reads the ELF file (output sections, their type and address) and the linker
+map file (input sections and the object they come from) and prints:
+- usage of FLASH, RAM1 and RAM2 with padding and alignment waste
+- every allocated output section with its fill bytes
+- the biggest objects with their FLASH, RAM1 and RAM2 share
+
+Sections loaded from flash and copied to RAM (.data, .ram2_text, .sysDiag)
+count in both memories. Fill is the padding the linker inserts for
+alignment inside an output section, gaps are bytes between output sections
+of one memory, reserved are bytes set aside by the linker script without an
+input section (`. = . + _Arena_Size`, heap and stack budget).
+
+Saved is the fill avoided by `SORT_BY_ALIGNMENT`: the input sections of an
+output section are laid out again in link order (objects as loaded, sections
+in object file order) with the alignment read from the object files, and the
+fill of that layout is compared with the actual one. Every input section is
+checked against its alignment, a misaligned variable fails the report.
+Library members are not read, their alignment is estimated from the address.
+
+The totals are compared with a budget file of `<memory or section> <bytes>`
+lines. The script fails when a value grows past its budget by more than the
+tolerance (bytes or percent of the budget). `--update` rewrites the values
+of the budget file from the current build.
+
+    ./size_report.py build/Debug/STM32L476RGT6.elf build/Debug/STM32L476RGT6.map
+    ./size_report.py firmware.elf firmware.map --budget size_budget.txt --tolerance 2%
+
+Built as the `size-report` and `size-budget-update` CMake targets.
+"""
+import argparse
+import os
+import re
+import sys
+from collections import OrderedDict, defaultdict, namedtuple
+
+from elf32 import Elf32, ElfError, SHF_ALLOC, SHT_NOBITS
+
+MEMORY_NAMES = {"RAM": "RAM1"}  # Linker script memory names shown as bank names
+MEMORY_ORDER = ("FLASH", "RAM1", "RAM2")
+
+ARCHIVE_MEMBER = re.compile(r"^(.*\.a)\((.+)\)$")
+MEMORY_LINE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+HEX = re.compile(r"^0x[0-9a-fA-F]+$")
+
+Input = namedtuple("Input", "section path address size fill")  # path None for fill
+
+
+class MapError(Exception):
+    pass
+
+
+def parse_map(path):
+    """Returns ({memory: (origin, length)}, {output section: [Input]}, [object paths in link order])."""
+    with open(path, "r", errors="replace") as file:
+        lines = file.read().splitlines()
+
+    memories = OrderedDict()
+    try:
+        start = lines.index("Memory Configuration") + 3
+        layout = lines.index("Linker script and memory map")
+    except ValueError:
+        raise MapError("%s is not a GNU ld map file" % path)
+    for line in lines[start:layout]:
+        match = MEMORY_LINE.match(line)
+        if match and match.group(1) != "*default*":
+            name = MEMORY_NAMES.get(match.group(1), match.group(1))
+            memories[name] = (int(match.group(2), 16), int(match.group(3), 16))
+
+    inputs = defaultdict(list)
+    loads = []
+    output = None
+    pending = None  # Name of an entry whose address and size are on the next line
+    reserve = False  # Next fill comes from `. = . + size`, not from alignment
+    for line in lines[layout + 1:]:
+        if not line.strip():
+            continue
+        fields = line.split()
+        if not line[0].isspace():
+            if fields[0] == "LOAD":
+                loads.append(" ".join(fields[1:]).replace("\\", "/"))
+                continue
+            # Output section, address and size may follow on the next line
+            output = fields[0]
+            pending = None
+            continue
+        if HEX.match(fields[0]) and len(fields) > 2 and fields[1:3] == [".", "="]:
+            reserve = "ALIGN" not in line
+            continue
+        if pending is None and not HEX.match(fields[0]):
+            if fields[0] == "*fill*" or (fields[0].startswith(".") or fields[0] == "COMMON"):
+                if len(fields) == 1:
+                    pending = fields[0]
+                    continue
+                name, fields = fields[0], fields[1:]
+            else:
+                continue  # Input section patterns, LOAD, OUTPUT
+        elif pending is not None:
+            name, pending = pending, None
+        else:
+            continue  # Symbol
+        if output is None or len(fields) < 2 or not HEX.match(fields[1]):
+            continue
+        address, size = int(fields[0], 16), int(fields[1], 16)
+        if name == "*fill*":
+            inputs[output].append(Input(None, None, address, 0, 0 if reserve else size))
+            reserve = False
+        elif len(fields) >= 3 and size:
+            inputs[output].append(Input(name, " ".join(fields[2:]).replace("\\", "/"), address, size, 0))
+    return memories, inputs, loads
+
+
+def object_name(path):
+    """Shortens CMake object paths and archive members."""
+    match = ARCHIVE_MEMBER.match(path)
+    if match:
+        return "%s(%s)" % (os.path.basename(match.group(1)), match.group(2))
+    marker = ".elf.dir/"
+    if marker in path:
+        return path[path.index(marker) + len(marker):]
+    return os.path.basename(path)
+
+
+class Alignments:
+    """Alignment and index of input sections, read from the object files of the link."""
+
+    def __init__(self, root, loads):
+        self.root = root
+        self.order = {path: index for index, path in enumerate(loads)}
+        self.objects = {}
+
+    def _object(self, path):
+        if path not in self.objects:
+            self.objects[path] = None
+            if not ARCHIVE_MEMBER.match(path):  # Library members are estimated
+                try:
+                    self.objects[path] = Elf32(os.path.join(self.root, path))
+                except (OSError, ElfError):
+                    pass
+        return self.objects[path]
+
+    def lookup(self, entry):
+        """Returns (alignment, known) of an input section, estimated from its address when unknown."""
+        elf = self._object(entry.path)
+        if elf is not None:
+            for section in elf.sections:
+                if section.name == entry.section:
+                    return max(section.align, 1), True
+        return min(entry.address & -entry.address or 8, 8), False
+
+    def link_key(self, entry):
+        """Position of an input section without sorting: object in link order, then section index."""
+        archive = ARCHIVE_MEMBER.match(entry.path)
+        order = self.order.get(archive.group(1) if archive else entry.path, len(self.order))
+        elf = self._object(entry.path)
+        if elf is not None:
+            for index, section in enumerate(elf.sections):
+                if section.name == entry.section:
+                    return order, index
+        return order, entry.address
+
+
+def packing(entries, alignments):
+    """Fill saved against the input sections in link order, alignment violations of the actual layout."""
+    placed = [entry for entry in entries if entry.path is not None]
+    violations = []
+    for entry in placed:
+        alignment, known = alignments.lookup(entry)
+        if known and entry.address % alignment:
+            violations.append((entry, alignment))
+    if len(placed) < 2:
+        return 0, violations
+    start = min(entry.address for entry in placed)
+    end = max(entry.address + entry.size for entry in placed)
+    address = start
+    for entry in sorted(placed, key=alignments.link_key):
+        alignment = alignments.lookup(entry)[0]
+        address = (address + alignment - 1) & -alignment
+        address += entry.size
+    # Fill after the last input section (trailing ALIGN) is the same in both layouts
+    return address - end, violations
+
+
+def memory_of(memories, address):
+    for name, (origin, length) in memories.items():
+        if origin <= address < origin + length:
+            return name
+    return None
+
+
+def analyze(elf, memories, inputs, alignments):
+    sections = []
+    violations = []
+    for section in elf.sections:
+        if not section.flags & SHF_ALLOC or section.size == 0:
+            continue
+        memory = memory_of(memories, section.address)
+        if memory is None:
+            continue
+        # Initialized sections outside flash keep their load image in flash
+        image = memory == "FLASH" or section.type != SHT_NOBITS
+        entries = inputs.get(section.name, [])
+        fill = sum(entry.fill for entry in entries)
+        covered = sum(entry.size for entry in entries) + fill
+        saved, misaligned = packing(entries, alignments)
+        violations += [(section.name,) + violation for violation in misaligned]
+        sections.append({
+            "name": section.name, "memory": memory, "address": section.address, "size": section.size,
+            "image": image, "fill": fill, "reserved": max(section.size - covered, 0), "entries": entries,
+            "saved": saved,
+        })
+
+    usage = OrderedDict((name, {"used": 0, "size": memories[name][1], "fill": 0, "gap": 0, "reserved": 0})
+                        for name in MEMORY_ORDER if name in memories)
+    for name in usage:
+        banked = sorted((s for s in sections if s["memory"] == name), key=lambda s: s["address"])
+        for previous, current in zip(banked, banked[1:]):
+            usage[name]["gap"] += max(current["address"] - previous["address"] - previous["size"], 0)
+        for section in banked:
+            usage[name]["used"] += section["size"]
+            usage[name]["fill"] += section["fill"]
+            usage[name]["reserved"] += section["reserved"]
+    for section in sections:
+        if section["memory"] != "FLASH" and section["image"]:
+            usage["FLASH"]["used"] += section["size"]
+
+    objects = defaultdict(lambda: dict.fromkeys(MEMORY_ORDER, 0))
+    for section in sections:
+        for entry in section["entries"]:
+            if entry.path is None:
+                continue
+            name = object_name(entry.path)
+            objects[name][section["memory"]] += entry.size
+            if section["memory"] != "FLASH" and section["image"]:
+                objects[name]["FLASH"] += entry.size
+    return usage, sections, objects, violations
+
+
+def title(text, rule):
+    """Centered title over a table, as the firmware prints them."""
+    side = len(rule) - len(text) - 6
+    return "+" + "-" * (side // 2) + "[ " + text + " ]" + "-" * (side - side // 2) + "+"
+
+
+def render(usage, sections, objects, violations, budget, top):
+    out = []
+    rule = "+--------+-----------+-----------+-------+----------+----------+----------+"
+    out.append(title("MEMORY", rule))
+    out.append("| Memory |  Used [B] |  Size [B] |  Use  | Fill [B] | Gaps [B] | Resv [B] |")
+    out.append(rule)
+    for name, entry in usage.items():
+        out.append("| %-6s | %9d | %9d | %4.1f%% | %8d | %8d | %8d |" % (
+            name, entry["used"], entry["size"], 100.0 * entry["used"] / entry["size"],
+            entry["fill"], entry["gap"], entry["reserved"]))
+    out.append(rule)
+    out.append("")
+
+    rule = "+------------------+--------+------------+-----------+----------+----------+-----------+"
+    out.append(title("SECTIONS", rule))
+    out.append("| Section          | Memory |  Address   |  Size [B] | Fill [B] | Resv [B] | Saved [B] |")
+    out.append(rule)
+    for section in sorted(sections, key=lambda s: (MEMORY_ORDER.index(s["memory"]), s["address"])):
+        memory = section["memory"] + ("+F" if section["memory"] != "FLASH" and section["image"] else "")
+        out.append("| %-16.16s | %-6s | 0x%08X | %9d | %8d | %8d | %9d |" % (
+            section["name"], memory, section["address"], section["size"], section["fill"], section["reserved"],
+            section["saved"]))
+    out.append(rule)
+    out.append("")
+
+    if violations:
+        rule = "+------------------+------------------------------------------+------------+-------+"
+        out.append(title("MISALIGNED", rule))
+        out.append("| Section          | Input section                            |  Address   | Align |")
+        out.append(rule)
+        for name, entry, alignment in violations:
+            out.append("| %-16.16s | %-40.40s | 0x%08X | %5d |" % (name, entry.section, entry.address, alignment))
+        out.append(rule)
+        out.append("")
+
+    if top > 0:
+        ranked = sorted(objects.items(), key=lambda item: -sum(item[1].values()))
+        rule = "+------------------------------------------+-----------+----------+----------+"
+        out.append(title("OBJECTS (top %d of %d)" % (min(top, len(ranked)), len(ranked)), rule))
+        out.append("| Object                                   | FLASH [B] | RAM1 [B] | RAM2 [B] |")
+        out.append(rule)
+        for name, sizes in ranked[:top]:
+            if len(name) > 40:
+                name = ".." + name[-38:]
+            out.append("| %-40s | %9d | %8d | %8d |" % (name, sizes["FLASH"], sizes["RAM1"], sizes["RAM2"]))
+        out.append(rule)
+        out.append("")
+
+    if budget:
+        rule = "+------------------+-----------+------------+------------+-----------------+"
+        out.append(title("BUDGET", rule))
+        out.append("| Item             |  Used [B] | Budget [B] |  Delta [B] | Status          |")
+        out.append(rule)
+        for item, used, limit, allowed in budget:
+            status = "ok" if used <= limit else ("over, tolerated" if used <= allowed else "REGRESSION")
+            out.append("| %-16.16s | %9d | %10d | %+10d | %-15s |" % (item, used, limit, used - limit, status))
+        out.append(rule)
+    return "\n".join(out)
+
+
+def read_budget(path):
+    budget = OrderedDict()
+    with open(path, "r") as file:
+        for number, line in enumerate(file, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            fields = line.split()
+            if len(fields) != 2 or not fields[1].isdigit():
+                raise ValueError("%s:%d: expected '<memory or section> <bytes>'" % (path, number))
+            budget[fields[0]] = int(fields[1])
+    return budget
+
+
+def write_budget(path, values):
+    """Replaces the values of existing lines, comments and order are kept."""
+    with open(path, "r") as file:
+        lines = file.read().splitlines()
+    for index, line in enumerate(lines):
+        fields = line.split("#", 1)[0].split()
+        if len(fields) == 2 and fields[0] in values:
+            lines[index] = "%-16s %d" % (fields[0], values[fields[0]])
+    with open(path, "w") as file:
+        file.write("\n".join(lines) + "\n")
+
+
+def measured(usage, sections):
+    values = {name: entry["used"] for name, entry in usage.items()}
+    for section in sections:
+        values[section["name"]] = section["size"]
+    return values
+
+
+def allowance(limit, tolerance):
+    if tolerance.endswith("%"):
+        return limit + int(limit * float(tolerance[:-1]) / 100.0)
+    return limit + int(tolerance, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="firmware ELF file, e.g. build/Debug/STM32L476RGT6.elf")
+    parser.add_argument("map", help="linker map file, e.g. build/Debug/STM32L476RGT6.map")
+    parser.add_argument("--budget", help="budget file, e.g. size_budget.txt")
+    parser.add_argument("--tolerance", default="0", help="allowed growth over the budget, bytes or percent (default 0)")
+    parser.add_argument("--update", action="store_true", help="write the current sizes into the budget file")
+    parser.add_argument("--root", default=".", help="directory the link ran in, object paths of the map are relative to it")
+    parser.add_argument("--top", type=int, default=20, help="number of objects listed, 0 for none (default 20)")
+    args = parser.parse_args()
+
+    memories, inputs, loads = parse_map(args.map)
+    usage, sections, objects, violations = analyze(Elf32(args.elf), memories, inputs, Alignments(args.root, loads))
+    values = measured(usage, sections)
+
+    if args.budget and args.update:
+        write_budget(args.budget, values)
+        print("Budget %s updated" % args.budget)
+        return 0
+
+    budget = []
+    if args.budget:
+        for item, limit in read_budget(args.budget).items():
+            if item not in values:
+                print("warning: budget item %s not found in %s" % (item, args.elf), file=sys.stderr)
+                continue
+            budget.append((item, values[item], limit, allowance(limit, args.tolerance)))
+
+    print(render(usage, sections, objects, violations, budget, args.top))
+    if violations:
+        print("error: %d input sections below their alignment" % len(violations), file=sys.stderr)
+        return 1
+    regressions = [item for item, used, _, allowed in budget if used > allowed]
+    if regressions:
+        print("error: memory budget exceeded by %s (tolerance %s)" % (", ".join(regressions), args.tolerance),
+              file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
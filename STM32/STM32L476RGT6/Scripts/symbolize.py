@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+"""Annotates code addresses in TrinityTrack6000 diagnostics output.
+
+Firmware reports print raw addresses (allocation call sites of the `a`
+command, fault program counters). Every `0x........` inside a function of
+the firmware ELF file gets the function name and offset appended at the
+end of its line, so the tables stay aligned.
+
+    stty -F /dev/ttyACM0 115200 raw -echo
+    ./symbolize.py build/Debug/STM32L476RGT6.elf /dev/ttyACM0
+    ./symbolize.py build/Debug/STM32L476RGT6.elf capture.txt
+
+Binary telemetry frames are not decoded, stop streaming (`t`) first.
+"""
+import argparse
+import re
+import sys
+
+from elf32 import Elf32
+
+ADDRESS = re.compile(rb"0x([0-9A-Fa-f]{8})")
+
+
+def annotate(elf, line):
+    names = []
+    for match in ADDRESS.finditer(line):
+        found = elf.function_at(int(match.group(1), 16))
+        if found is not None:
+            names.append("%s+0x%X" % found)
+    if not names:
+        return line
+    end = len(line.rstrip(b"\r\n"))
+    return line[:end] + (" <- " + ", ".join(names)).encode() + line[end:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="firmware ELF file, e.g. build/Debug/STM32L476RGT6.elf")
+    parser.add_argument("source", help="serial device or capture file, '-' for stdin")
+    args = parser.parse_args()
+
+    elf = Elf32(args.elf)
+    stream = sys.stdin.buffer if args.source == "-" else open(args.source, "rb", buffering=0)
+    out = sys.stdout.buffer
+    for line in iter(stream.readline, b""):
+        out.write(annotate(elf, line))
+        out.flush()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,239 @@
+#!/usr/bin/env python3
+"""Decoder for TrinityTrack6000 binary memory telemetry.
+
+Reads COBS framed telemetry (see Utils/TrinityTrack6000_Telemetry.h) from a
+serial device or a capture file and renders the same tables as the ASCII
+RAM diagnostics of the firmware.
+
+    stty -F /dev/ttyACM0 115200 raw -echo
+    ./telemetry_decode.py /dev/ttyACM0            # send 't' to start streaming
+    ./telemetry_decode.py capture.bin --once
+
+Frames with a bad CRC or an unknown schema version are counted and skipped.
+"""
+import argparse
+import struct
+import sys
+
+SCHEMA_VERSION = 3
+
+FRAME_MEMORY = 0x01
+FRAME_LAYOUT = 0x02
+FRAME_LOG = 0x03
+
+# Mirrors TELEMETRY_MEMORY_RECORDS(), id: (struct format, name)
+MEMORY_RECORDS = {
+    0x01: ("<I", "ramDiagnosticsGeneral_total_size"),
+    0x02: ("<I", "ramDiagnosticsGeneral_used"),
+    0x03: ("<I", "ramDiagnosticsRAM1_lastMSP"),
+    0x04: ("<I", "ramDiagnosticsRAM1_lastHeapEnd"),
+    0x05: ("<I", "ramDiagnosticsRAM1_stackHighWater"),
+    0x10: ("<I", "global_error_code"),
+}
+
+# Generic records of the MemInfo bank and region tables, id is base + index
+RECORD_BANK = 0x20
+RECORD_REGION = 0x40
+NAME_SIZE = 8  # MEMINFO_NAME_SIZE
+REGION_GROWS_DOWN = 0x01  # MEMINFO_REGION_GROWS_DOWN
+
+MEMORY_GENERIC = "<I"  # Used bytes of bank or region
+LAYOUT_BANK = "<II%ds" % NAME_SIZE  # Start, end, name
+LAYOUT_REGION = "<BBII%ds" % NAME_SIZE  # Bank, flags, start, end, name
+
+
+class FrameError(Exception):
+    pass
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, same as telemetryCrc16()."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            raise FrameError("bad COBS code")
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def decode_frame(encoded):
+    """Returns (frame type, sequence, records) of a checked frame."""
+    payload = cobs_decode(encoded)
+    if len(payload) < 5:
+        raise FrameError("frame too short")
+    body, crc = payload[:-2], struct.unpack("<H", payload[-2:])[0]
+    if crc16(body) != crc:
+        raise FrameError("CRC mismatch")
+    version, frame_type, sequence = body[0], body[1], body[2]
+    if version != SCHEMA_VERSION:
+        raise FrameError("schema version %d, decoder supports %d" % (version, SCHEMA_VERSION))
+    return frame_type, sequence, body[3:]
+
+
+def parse_frame(encoded):
+    """Returns (frame type, sequence, values), log frames are returned with raw records.
+
+    Values of memory and layout frames are {name: value} of scalar records
+    plus "banks" and "regions" dicts {index: value} of generic records.
+    """
+    frame_type, sequence, body = decode_frame(encoded)
+    if frame_type == FRAME_LOG:
+        return frame_type, sequence, {"records": body}
+
+    values = {"banks": {}, "regions": {}}
+    i = 0
+    while i < len(body):
+        record_id = body[i]
+        i += 1
+        table, index = None, None
+        if record_id >= RECORD_REGION and frame_type in (FRAME_MEMORY, FRAME_LAYOUT):
+            table, index = "regions", record_id - RECORD_REGION
+            fmt = MEMORY_GENERIC if frame_type == FRAME_MEMORY else LAYOUT_REGION
+        elif record_id >= RECORD_BANK and frame_type in (FRAME_MEMORY, FRAME_LAYOUT):
+            table, index = "banks", record_id - RECORD_BANK
+            fmt = MEMORY_GENERIC if frame_type == FRAME_MEMORY else LAYOUT_BANK
+        elif frame_type == FRAME_MEMORY and record_id in MEMORY_RECORDS:
+            fmt, name = MEMORY_RECORDS[record_id]
+        else:
+            raise FrameError("unknown record 0x%02X in frame type 0x%02X" % (record_id, frame_type))
+        size = struct.calcsize(fmt)
+        if i + size > len(body):
+            raise FrameError("truncated record 0x%02X" % record_id)
+        value = struct.unpack(fmt, body[i:i + size])
+        i += size
+        if table is None:
+            values[name] = value[0]
+        elif frame_type == FRAME_MEMORY:
+            values[table][index] = value[0]
+        else:
+            values[table][index] = value[:-1] + (value[-1].rstrip(b"\x00").decode("ascii", "replace"),)
+    return frame_type, sequence, values
+
+
+def bar(used, total):
+    percent = used * 100 // total if total else 0
+    filled = min(10, percent * 11 // 100)
+    return "#" * filled + "-" * (10 - filled), percent
+
+
+def title(text):
+    left = (70 - len(text)) // 2
+    return "+" + "-" * left + text + "-" * (70 - left - len(text)) + "+"
+
+
+def render(memory, layout):
+    """Same tables as ramDiagnosticsGeneral() followed by ramDiagnosticsBank() of every bank."""
+    m = memory
+    banks = layout.get("banks", {})
+    regions = layout.get("regions", {})
+    free = "| FREE RAM TOTAL: %8u B" + " " * 43 + "|"
+    footer = "+" + "-" * 70 + "+"
+    lines = []
+
+    lines.append(title("[ RAM DIAGNOSTICS ]"))
+    lines.append("| Bank   | Start      | End        | Size [B] | Usage      | Used      |")
+    lines.append("+--------+------------+------------+----------+------------+-----------+")
+    for index, (start, end, name) in sorted(banks.items()):
+        graph, percent = bar(m["banks"].get(index, 0), end - start)
+        lines.append("| %-6s | 0x%08X | 0x%08X | %8u | %10s | %3u%%      |" % (name, start, end, end - start, graph, percent))
+    lines.append("+--------+------------+------------+----------+------------+-----------+")
+    lines.append(free % (m["ramDiagnosticsGeneral_total_size"] - m["ramDiagnosticsGeneral_used"]))
+
+    for bank, (bank_start, bank_end, bank_name) in sorted(banks.items()):
+        lines.append(title("[ BANK %s DETAILS ]" % bank_name))
+        lines.append("| Section | Start      | End        |  Size [B] |  Used [B] | Usage    |")
+        lines.append("+---------+------------+------------+-----------+-----------+----------+")
+        for index, (region_bank, flags, start, end, name) in sorted(regions.items()):
+            if region_bank != bank:
+                continue
+            size = end - start
+            used = m["regions"].get(index, 0)
+            if flags & REGION_GROWS_DOWN:
+                start = end - used
+            else:
+                end = start + used
+            percent = used * 100 // size if size else 0
+            lines.append("| %-7s | 0x%08X | 0x%08X | %9u | %9u | %3u%%     |" % (name, start, end, size, used, percent))
+        lines.append("+---------+------------+------------+-----------+-----------+----------+")
+        lines.append(free % (bank_end - bank_start - m["banks"].get(bank, 0)))
+    lines.append("| ERROR CODE: 0x%08X%s|" % (m["global_error_code"], " " * 47))
+    lines.append(footer)
+    return "\n".join(lines)
+
+
+def frames(stream):
+    """Yields encoded frames split at 0x00, ASCII output between frames ends up as bad frames."""
+    pending = bytearray()
+    while True:
+        chunk = stream.read(1) if hasattr(stream, "isatty") and stream.isatty() else stream.read(256)
+        if not chunk:
+            return
+        pending += chunk
+        while True:
+            end = pending.find(b"\x00")
+            if end < 0:
+                break
+            frame = bytes(pending[:end])
+            del pending[:end + 1]
+            if frame:
+                yield frame
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("source", help="serial device or capture file, '-' for stdin")
+    parser.add_argument("--once", action="store_true", help="exit after the first rendered table")
+    parser.add_argument("--raw", action="store_true", help="print decoded records instead of tables")
+    args = parser.parse_args()
+
+    stream = sys.stdin.buffer if args.source == "-" else open(args.source, "rb", buffering=0)
+    layout = {}
+    stats = {"frames": 0, "errors": 0, "lost": 0}
+    last_sequence = None
+
+    for encoded in frames(stream):
+        try:
+            frame_type, sequence, values = parse_frame(encoded)
+        except FrameError as error:
+            stats["errors"] += 1
+            if args.raw:
+                print("bad frame: %s" % error, file=sys.stderr)
+            continue
+        if last_sequence is not None:
+            stats["lost"] += (sequence - last_sequence - 1) & 0xFF
+        last_sequence = sequence
+        stats["frames"] += 1
+
+        if frame_type == FRAME_LOG:
+            continue  # Decoded by log_decode.py
+        if args.raw:
+            print("seq %3u type 0x%02X %s" % (sequence, frame_type, " ".join("%s=%r" % item for item in values.items())))
+            continue
+        if frame_type == FRAME_LAYOUT:
+            layout = values
+        elif frame_type == FRAME_MEMORY:
+            sys.stdout.write("\x1b[H\x1b[2J" if sys.stdout.isatty() and not args.once else "")
+            print(render(values, layout))
+            print("frames %(frames)u, bad %(errors)u, lost %(lost)u" % stats)
+            if args.once:
+                break
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,243 @@
+/**
+ * @file uart_tx_test.c
+ * @brief Host test of the UART transmit ring against a mocked USART/DMA.
+ *
+ * TrinityTrack6000_UartTx.c is compiled unchanged, `Scripts/mock` shadows
+ * the HAL and CMSIS headers. The mock `HAL_UART_Transmit_DMA()` records
+ * the chunk it was given, the test plays the DMA by copying it out and
+ * calling `uartTxTransferComplete()`.
+ *
+ *     gcc -O2 -Wall -Wextra -IScripts/mock -IInclude -IUtils Scripts/uart_tx_test.c \
+ *         Utils/TrinityTrack6000_UartTx.c -o uart_tx_test
+ *     ./uart_tx_test
+ *
+ * Covers wrap-around chunking, chaining on transfer complete, dropped bytes
+ * when full, a transmitter busy on start and the in-flight/idle transitions.
+ *
+ * @date 2025.09.27
+ * @author Alan Kudełko
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <stm32l4xx_hal.h>
+#include <core_cm4.h>
+#include <TrinityTrack6000_UartTx.h>
+
+UART_HandleTypeDef uart;
+DMA_HandleTypeDef uart_dma_tx;
+DMA_HandleTypeDef uart_dma_rx;
+
+uint32_t mock_cycles;
+uint32_t mock_criticalDepth;
+uint32_t mock_criticalEntries;
+DWT_Type mock_dwt;
+CoreDebug_Type mock_coreDebug;
+
+// Mocked DMA channel, one transfer at a time
+static const uint8_t*mock_dmaData;
+static uint16_t mock_dmaSize;
+static uint32_t mock_dmaStarts;
+static HAL_StatusTypeDef mock_dmaStatus=HAL_OK;
+
+// Bytes "on the wire", in order
+static uint8_t test_wire[4*UART_TX_BUFFER_SIZE];
+static uint32_t test_wireLength;
+static uint8_t test_sent[4*UART_TX_BUFFER_SIZE];
+static uint32_t test_sentLength;
+static uint32_t test_failures;
+static uint8_t test_inInterrupt;
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef*huart,const uint8_t*data,uint16_t size){
+	if(huart!=&uart){
+		return HAL_ERROR;
+	}
+	if(!test_inInterrupt&&mock_criticalDepth==0){
+		printf("FAIL transfer started from thread context outside a critical section\n");
+		test_failures++;
+	}
+	if(mock_dmaStatus!=HAL_OK){
+		return mock_dmaStatus;
+	}
+	if(mock_dmaData!=NULL){
+		printf("FAIL transfer started while one is in flight\n");
+		test_failures++;
+	}
+	mock_dmaData=data;
+	mock_dmaSize=size;
+	mock_dmaStarts++;
+	return HAL_OK;
+}
+
+#define CHECK(condition) \
+	do{ \
+		if(!(condition)){ \
+			printf("FAIL %s:%d %s\n",__func__,__LINE__,#condition); \
+			test_failures++; \
+		} \
+	}while(0)
+
+// Completes the transfer in flight, as the DMA interrupt would
+static uint16_t testComplete(void){
+	uint16_t size=mock_dmaSize;
+
+	if(mock_dmaData==NULL){
+		return 0;
+	}
+	memcpy(&test_wire[test_wireLength],mock_dmaData,size);
+	test_wireLength+=size;
+	mock_dmaData=NULL;
+	mock_dmaSize=0;
+	test_inInterrupt=1;
+	uartTxTransferComplete();
+	test_inInterrupt=0;
+	return size;
+}
+
+static void testDrain(void){
+	while(testComplete()!=0){
+	}
+}
+
+static HAL_StatusTypeDef testWrite(uint16_t length){
+	uint8_t data[UART_TX_BUFFER_SIZE+1];
+	HAL_StatusTypeDef status;
+
+	for(uint16_t i=0;i<length;i++){
+		data[i]=(uint8_t)(test_sentLength+i*7+1);
+	}
+	status=uartTxWrite(data,length);
+	if(status==HAL_OK){
+		memcpy(&test_sent[test_sentLength],data,length);
+		test_sentLength+=length;
+	}
+	CHECK(mock_criticalDepth==0);
+	return status;
+}
+
+static void testReset(void){
+	mock_dmaData=NULL;
+	mock_dmaSize=0;
+	mock_dmaStarts=0;
+	mock_dmaStatus=HAL_OK;
+	mock_criticalEntries=0;
+	test_wireLength=0;
+	test_sentLength=0;
+	uartTxInit();
+}
+
+static void testWireMatches(void){
+	CHECK(test_wireLength==test_sentLength);
+	CHECK(memcmp(test_wire,test_sent,test_sentLength)==0);
+}
+
+static void testIdleTransitions(void){
+	testReset();
+	CHECK(uartTxIsIdle());
+	CHECK(uartTxPending()==0);
+
+	CHECK(testWrite(10)==HAL_OK);
+	CHECK(mock_dmaStarts==1);
+	CHECK(mock_dmaSize==10);
+	CHECK(!uartTxIsIdle());
+	CHECK(uartTxPending()==10);
+
+	CHECK(testComplete()==10);
+	CHECK(uartTxIsIdle());
+	CHECK(uartTxPending()==0);
+	CHECK(mock_dmaStarts==1);
+	testWireMatches();
+}
+
+static void testChaining(void){
+	testReset();
+	CHECK(testWrite(100)==HAL_OK);
+	CHECK(testWrite(50)==HAL_OK);   // Queued behind the transfer in flight
+	CHECK(testWrite(25)==HAL_OK);
+	CHECK(mock_dmaStarts==1);
+	CHECK(mock_dmaSize==100);
+	CHECK(mock_criticalEntries==1); // Only the first write starts the DMA
+
+	CHECK(testComplete()==100);
+	CHECK(mock_dmaStarts==2);       // Completion chains the rest in one chunk
+	CHECK(mock_dmaSize==75);
+	CHECK(!uartTxIsIdle());
+
+	CHECK(testComplete()==75);
+	CHECK(uartTxIsIdle());
+	testWireMatches();
+}
+
+static void testWrapAround(void){
+	testReset();
+	CHECK(testWrite(UART_TX_BUFFER_SIZE-16)==HAL_OK);
+	testDrain();
+
+	// 16 bytes to the end of the ring, 24 from its start
+	CHECK(testWrite(40)==HAL_OK);
+	CHECK(mock_dmaSize==16);
+	CHECK(testComplete()==16);
+	CHECK(mock_dmaSize==24);
+	CHECK(testComplete()==24);
+	CHECK(uartTxIsIdle());
+	testWireMatches();
+}
+
+static void testFull(void){
+	testReset();
+	CHECK(testWrite(1000)==HAL_OK);                       // In flight, still counts as used
+	CHECK(testWrite(UART_TX_BUFFER_SIZE-1000)==HAL_OK);   // Exactly full
+	CHECK(uartTxPending()==UART_TX_BUFFER_SIZE);
+	CHECK(uartTx_peakUsage==UART_TX_BUFFER_SIZE);
+
+	CHECK(testWrite(1)==HAL_BUSY);
+	CHECK(testWrite(300)==HAL_BUSY);                      // All or nothing
+	CHECK(uartTx_droppedBytes==301);
+	CHECK(uartTxPending()==UART_TX_BUFFER_SIZE);
+
+	CHECK(testComplete()==1000);
+	CHECK(testWrite(300)==HAL_OK);                        // Space released by the completion
+	CHECK(uartTx_droppedBytes==301);
+	testDrain();
+	CHECK(uartTxIsIdle());
+	testWireMatches();
+}
+
+static void testTransmitterBusy(void){
+	testReset();
+	mock_dmaStatus=HAL_BUSY;
+	CHECK(testWrite(20)==HAL_OK);  // Enqueued, the start failed
+	CHECK(mock_dmaStarts==0);
+	CHECK(!uartTxIsIdle());        // Pending bytes, nothing in flight
+
+	mock_dmaStatus=HAL_OK;
+	CHECK(testWrite(5)==HAL_OK);   // Next write retries with everything pending
+	CHECK(mock_dmaStarts==1);
+	CHECK(mock_dmaSize==25);
+	testDrain();
+	CHECK(uartTxIsIdle());
+	testWireMatches();
+}
+
+static void testLatency(void){
+	testReset();
+	CHECK(testWrite(8)==HAL_OK);
+	CHECK(uartTx_enqueueCyclesLast>0);
+	CHECK(uartTx_enqueueCyclesMax>=uartTx_enqueueCyclesLast);
+	CHECK((mock_coreDebug.DEMCR&CoreDebug_DEMCR_TRCENA_Msk)!=0);
+	CHECK((mock_dwt.CTRL&DWT_CTRL_CYCCNTENA_Msk)!=0);
+	testDrain();
+}
+
+int main(void){
+	testIdleTransitions();
+	testChaining();
+	testWrapAround();
+	testFull();
+	testTransmitterBusy();
+	testLatency();
+
+	printf("%s, %lu failures\n",test_failures?"FAIL":"PASS",(unsigned long)test_failures);
+	return test_failures!=0;
+}
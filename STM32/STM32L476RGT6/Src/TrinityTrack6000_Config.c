@@ -1,3 +1,5 @@
 #include <TrinityTrack6000_Config.h>
 
-UART_HandleTypeDef uart;
\ No newline at end of file
+UART_HandleTypeDef uart;
+DMA_HandleTypeDef uart_dma_tx;
+DMA_HandleTypeDef uart_dma_rx;
\ No newline at end of file
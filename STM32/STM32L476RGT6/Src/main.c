@@ -15,60 +15,51 @@
   ******************************************************************************
   */
 #include <main.h>
-#include <string.h>
 #include <stdint.h>
-#include <stdlib.h>
-#include <stdio.h>
 
 #include <TrinityTrack6000_Config.h>
-
-extern void ramDiagnosticsGeneral();
-extern void ramDiagnosticsRefresh();
-extern void ramDiagnosticsRAM1();
-extern void ramDiagnosticsRAM2();
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Commands.h>
+#include <TrinityTrack6000_Log.h>
+#include <TrinityTrack6000_Telemetry.h>
+#include <TrinityTrack6000_Format.h>
+#include <TrinityTrack6000_Pool.h>
+#include <TrinityTrack6000_Arena.h>
+#include <TrinityTrack6000_Task.h>
+#include <TrinityTrack6000_Crash.h>
+#include <TrinityTrack6000_Boot.h>
+#include <TrinityTrack6000_Idle.h>
 
 extern void initializeSystem();
 
-void send_string(UART_HandleTypeDef*uart,char*s){
-    HAL_UART_Transmit(uart,(uint8_t*)s,strlen(s),1000);
-}
-
 /**
   * @brief  The application entry point.
   * @retval int
   */
 int main(void){
     initializeSystem();
-    uint32_t*t=malloc(1900*sizeof(uint32_t));
-    t[0]=123456;
-    ramDiagnosticsRefresh();
-    ramDiagnosticsGeneral();
-    ramDiagnosticsRAM1();
-    ramDiagnosticsRAM2();
-
-    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
-    DWT->CYCCNT = 0;            // zerowanie licznika
-    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;  // włączenie licznika
-    float x=2.71f;
-    float y=3.14f;
-    float z;
-    uint32_t start=DWT->CYCCNT;
-    z=x/y;
-    uint32_t end=DWT->CYCCNT;
-    x=z;
-    char buffer[50];
-    snprintf(buffer,50,"CYCLES: %lu\r\n",end-start);
-    HAL_UART_Transmit(&uart,(uint8_t*)buffer,strlen(buffer),1000);
+    uint32_t*t=poolAlloc(1900*sizeof(uint32_t));
+    if(t!=NULL){
+        t[0]=123456;
+    }
 
     GPIOA->MODER &= ~(0b11 << (5 * 2)); // wyczyść bity MODER5
     GPIOA->MODER |=  (0b01 << (5 * 2)); // ustaw jako output
     GPIOA->OTYPER &= ~(1 << 5);
     GPIOA->PUPDR &= ~(0b11 << (5 * 2));
 
-    int i=0;
-    while (i++<100){
-        GPIOA->ODR ^= (1 << 5);
-	      HAL_Delay(100);
+    uint8_t ledDivider=0;
+    while (1){
+        taskRun(TASK_commands);
+        taskRun(TASK_telemetry);
+        taskRun(TASK_log);
+        if(++ledDivider>=100/MAIN_LOOP_PERIOD_MS){
+            ledDivider=0;
+            GPIOA->ODR ^= (1 << 5);
+        }
+        bootDeferred(); // Reports, banners and benchmarks run after the first control cycle
+        crashCycle(); // Recovery time of a warm boot, restart count cleared once stable
+        arenaReset(&arena_scratch); // Scratch memory lives for one cycle
+        idleWaitPeriod(MAIN_LOOP_PERIOD_MS); // Tickless Sleep until the next cycle
     }
-    GPIOA->ODR|=(1<<5);
 }
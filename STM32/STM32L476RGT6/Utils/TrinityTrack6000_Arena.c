@@ -0,0 +1,29 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include <TrinityTrack6000_Arena.h>
+
+extern uint8_t __ARENA_START__; // Defined in the linker script
+extern uint8_t __ARENA_END__;
+
+Arena arena_scratch={&__ARENA_START__,&__ARENA_END__,0,0,0};
+
+void*arenaAlloc(Arena*arena,uint32_t size,uint32_t alignment){
+	uint32_t capacity=(uint32_t)(arena->end-arena->base);
+	uint32_t address=((uint32_t)arena->base+arena->used+alignment-1)&~(alignment-1);
+	uint32_t offset=address-(uint32_t)arena->base;
+
+	if(offset>capacity||size>capacity-offset){
+		arena->failed++;
+		return NULL;
+	}
+	arena->used=offset+size;
+	if(arena->used>arena->peak){
+		arena->peak=arena->used;
+	}
+	return (void*)address;
+}
+
+uint32_t arenaUsedEnd(void){
+	return (uint32_t)arena_scratch.base+arena_scratch.peak;
+}
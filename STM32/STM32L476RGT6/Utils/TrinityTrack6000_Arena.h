@@ -0,0 +1,90 @@
+/**
+ * @file TrinityTrack6000_Arena.h
+ * @brief Arena (bump) allocator for per-cycle scratch memory in TrinityTrack6000 project.
+ *
+ * Temporary buffers (formatted report lines, telemetry scratch) taken from
+ * the stack inflate the worst case stack of every task calling them. An arena
+ * hands out memory by moving an offset forward and gives it all back at once:
+ * - `arenaAlloc()` aligns the offset, checks the capacity and bumps it
+ * - `arenaMark()`/`arenaRelease()` scope allocations, release is a single store
+ * - `arenaReset()` frees everything, called at the end of every main loop cycle
+ *
+ * `arena_scratch` is backed by the `.arena` linker section in RAM1,
+ * `_Arena_Size` bytes reserved by the linker script. Its peak usage is the
+ * `.ARENA` region of `MEMINFO_REGIONS`, reported beside `.HEAP`.
+ * C++ code uses the RAII scope from TrinityTrack6000_Arena.hpp.
+ *
+ * An arena is not reentrant, `arena_scratch` belongs to the main loop and
+ * must not be used from interrupts.
+ *
+ * @date 2025.09.18
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_ARENA_H_
+    #define _TRINITYTRACK6000_ARENA_H_
+
+#include <stdint.h>
+
+#define ARENA_ALIGNMENT_DEFAULT 8 /**< Alignment of arenaAlloc() callers that do not care, fits any scalar type */
+
+/**
+ * @brief Arena state
+ */
+typedef struct{
+    uint8_t*base;    /**< First byte of arena */
+    uint8_t*end;     /**< First byte after arena */
+    uint32_t used;   /**< Offset of first free byte */
+    uint32_t peak;   /**< High-water mark of used */
+    uint32_t failed; /**< Allocations refused, arena full */
+}Arena;
+
+extern Arena arena_scratch; /**< Scratch arena of the main loop, reset every cycle */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Allocate memory from arena.
+ * @param arena Arena
+ * @param size Number of bytes
+ * @param alignment Power of 2 alignment of the returned address
+ * @retval Pointer to memory or NULL if the arena is full
+ */
+void*arenaAlloc(Arena*arena,uint32_t size,uint32_t alignment);
+
+/**
+ * @brief End of used part of `.ARENA` region, start plus peak usage.
+ *
+ * The arena is empty between cycles, so MemInfo reports its high-water mark.
+ *
+ * @retval Address used by MemInfo to compute region usage
+ */
+uint32_t arenaUsedEnd(void);
+
+/**
+ * @brief Current position, allocations after it are released by `arenaRelease()`.
+ */
+static inline uint32_t arenaMark(const Arena*arena){
+    return arena->used;
+}
+
+/**
+ * @brief Release all allocations made after mark.
+ */
+static inline void arenaRelease(Arena*arena,uint32_t mark){
+    arena->used=mark;
+}
+
+/**
+ * @brief Release all allocations, a single store.
+ */
+static inline void arenaReset(Arena*arena){
+    arena->used=0;
+}
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_ARENA_H_
@@ -0,0 +1,85 @@
+/**
+ * @file TrinityTrack6000_Arena.hpp
+ * @brief RAII scope of the arena allocator for TrinityTrack6000 project.
+ *
+ * `ArenaScope` remembers the arena position when constructed and releases
+ * everything allocated through it when it goes out of scope:
+ *
+ *     {
+ *         ArenaScope scope;                       // arena_scratch
+ *         char*line=scope.allocate<char>(90);
+ *         Sample*sample=scope.make<Sample>(1,2);  // placement new
+ *     }                                           // single store, memory is back
+ *
+ * Destructors of objects created by `make()` are never run, so only
+ * trivially destructible types are accepted. Built without exceptions,
+ * failed allocations return nullptr.
+ *
+ * @date 2025.09.18
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_ARENA_HPP_
+    #define _TRINITYTRACK6000_ARENA_HPP_
+
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <TrinityTrack6000_Arena.h>
+
+class ArenaScope{
+public:
+    explicit ArenaScope(Arena&arena=arena_scratch):arena_(arena),mark_(arenaMark(&arena)){
+    }
+
+    ~ArenaScope(){
+        arenaRelease(&arena_,mark_);
+    }
+
+    ArenaScope(const ArenaScope&)=delete;
+    ArenaScope&operator=(const ArenaScope&)=delete;
+
+    /**
+     * @brief Allocate raw memory.
+     * @param size Number of bytes
+     * @param alignment Power of 2 alignment
+     */
+    void*allocate(uint32_t size,uint32_t alignment=ARENA_ALIGNMENT_DEFAULT){
+        return arenaAlloc(&arena_,size,alignment);
+    }
+
+    /**
+     * @brief Allocate uninitialized array of T.
+     * @param count Number of elements
+     */
+    template<typename T>
+    T*allocate(uint32_t count=1){
+        static_assert(std::is_trivially_destructible<T>::value,"Arena memory is released without destructors");
+        return static_cast<T*>(arenaAlloc(&arena_,static_cast<uint32_t>(sizeof(T))*count,alignof(T)));
+    }
+
+    /**
+     * @brief Construct T in arena memory.
+     * @param arguments Constructor arguments
+     */
+    template<typename T,typename... Arguments>
+    T*make(Arguments&&... arguments){
+        void*memory=allocate<T>();
+
+        return memory?new(memory) T(std::forward<Arguments>(arguments)...):nullptr;
+    }
+
+    /**
+     * @brief Bytes allocated through this scope.
+     */
+    uint32_t used(void) const{
+        return arena_.used-mark_;
+    }
+
+private:
+    Arena&arena_;
+    const uint32_t mark_;
+};
+
+#endif // _TRINITYTRACK6000_ARENA_HPP_
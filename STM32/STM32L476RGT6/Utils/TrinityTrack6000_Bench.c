@@ -0,0 +1,178 @@
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <TrinityTrack6000_Bench.h>
+#include <TrinityTrack6000_Format.h>
+
+#ifdef BENCH_HOST
+    #include <stdio.h>
+    #include <time.h>
+#else
+    #include <stm32l4xx_hal.h>
+    #include <core_cm4.h>
+    #include <TrinityTrack6000_UartTx.h>
+#endif
+
+#define BENCH_LINE_SIZE 128
+
+extern const BenchCase __start_bench_registry[]; // Defined by the linker
+extern const BenchCase __stop_bench_registry[];
+
+static uint32_t bench_samples[BENCH_ITERATIONS];
+static uint32_t bench_overhead=0;
+
+// uint32_t is unsigned long on the target and unsigned int on the host, formatString() reads 32 bits for both
+static const char bench_formatStringResult[]="BENCH %s " BENCH_UNIT " n=%u min=%" PRIu32 " med=%" PRIu32 " max=%" PRIu32
+	" mean=%" PRIu32 ".%02" PRIu32 " sd=%" PRIu32 ".%02" PRIu32 " ovh=%" PRIu32 "\r\n";
+
+#ifdef BENCH_HOST
+static uint32_t benchNow(void){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC,&now);
+	return (uint32_t)(now.tv_sec*1000000000ULL+now.tv_nsec);
+}
+
+static void benchWrite(const char*line,uint16_t length){
+	fwrite(line,1,length,stdout);
+}
+
+static uint32_t benchSample(void(*run)(void)){
+	uint32_t start=benchNow();
+
+	run();
+	return benchNow()-start;
+}
+#else
+static void benchWrite(const char*line,uint16_t length){
+	uartTxWrite((const uint8_t*)line,length);
+}
+
+static uint32_t benchSample(void(*run)(void)){
+	uint32_t primask=__get_PRIMASK();
+	uint32_t start;
+	uint32_t cycles;
+
+	__disable_irq();
+	start=DWT->CYCCNT;
+	run();
+	cycles=DWT->CYCCNT-start;
+	__set_PRIMASK(primask);
+
+	return cycles;
+}
+#endif
+
+// Reference for the overhead, the indirect call and the timer reads around it
+__attribute__((noinline)) static void benchEmpty(void){
+	BENCH_CLOBBER();
+}
+
+static uint32_t benchSqrt(uint64_t value){
+	uint64_t root=0;
+	uint64_t bit=1ULL<<62;
+
+	while(bit>value){
+		bit>>=2;
+	}
+	while(bit!=0){
+		if(value>=root+bit){
+			value-=root+bit;
+			root=(root>>1)+bit;
+		}
+		else{
+			root>>=1;
+		}
+		bit>>=2;
+	}
+	return (uint32_t)root;
+}
+
+void benchMeasure(void(*run)(void),BenchResult*result){
+	uint64_t sum=0;
+	uint64_t mean100;
+	uint64_t spread;
+	uint64_t variance=0;
+	uint64_t stddev100;
+	uint8_t shift=0;
+
+	for(uint8_t i=0;i<BENCH_WARMUP;i++){
+		run();
+	}
+	for(uint16_t i=0;i<BENCH_ITERATIONS;i++){
+		uint32_t sample=benchSample(run);
+		uint16_t j=i;
+
+		sample=(sample>bench_overhead)?sample-bench_overhead:0;
+		// Insertion keeps the samples sorted for the median
+		while(j>0&&bench_samples[j-1]>sample){
+			bench_samples[j]=bench_samples[j-1];
+			j--;
+		}
+		bench_samples[j]=sample;
+		sum+=sample;
+	}
+	mean100=sum*100U/BENCH_ITERATIONS;
+
+	// Deviations in hundredths, shifted until the largest one squares within 64 bits (one preemption can be huge)
+	spread=(uint64_t)bench_samples[BENCH_ITERATIONS-1]*100U-mean100;
+	if(mean100-(uint64_t)bench_samples[0]*100U>spread){
+		spread=mean100-(uint64_t)bench_samples[0]*100U;
+	}
+	while((spread>>shift)>UINT32_MAX){
+		shift++;
+	}
+	for(uint16_t i=0;i<BENCH_ITERATIONS;i++){
+		uint64_t sample100=(uint64_t)bench_samples[i]*100U;
+		uint64_t deviation=((sample100>mean100)?sample100-mean100:mean100-sample100)>>shift;
+
+		variance+=deviation*deviation/BENCH_ITERATIONS; // Divided first, the sum stays below 2^64
+	}
+	stddev100=(uint64_t)benchSqrt(variance)<<shift;
+
+	result->min=bench_samples[0];
+	result->median=bench_samples[BENCH_ITERATIONS/2];
+	result->max=bench_samples[BENCH_ITERATIONS-1];
+	result->mean100=(mean100>UINT32_MAX)?UINT32_MAX:(uint32_t)mean100;
+	result->stddev100=(stddev100>UINT32_MAX)?UINT32_MAX:(uint32_t)stddev100;
+}
+
+void benchCalibrate(void){
+	BenchResult result;
+
+#ifndef BENCH_HOST
+	CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL|=DWT_CTRL_CYCCNTENA_Msk;
+#endif
+	// Overhead is the minimum, subtracting more would make short kernels negative
+	bench_overhead=0;
+	benchMeasure(benchEmpty,&result);
+	bench_overhead=result.min;
+}
+
+void benchPrint(const char*name,const BenchResult*result){
+	char buffer[BENCH_LINE_SIZE];
+	uint16_t length;
+
+	length=formatString(buffer,sizeof(buffer),bench_formatStringResult,
+		name,                                        // Kernel
+		(unsigned)BENCH_ITERATIONS,                  // Samples
+		result->min,                                 // Fastest
+		result->median,                              // Median
+		result->max,                                 // Slowest
+		result->mean100/100,result->mean100%100,     // Mean
+		result->stddev100/100,result->stddev100%100, // Standard deviation
+		bench_overhead                               // Subtracted from every sample
+	);
+	benchWrite(buffer,length);
+}
+
+void benchRunAll(void){
+	BenchResult result;
+
+	benchCalibrate();
+	for(const BenchCase*test=__start_bench_registry;test<__stop_bench_registry;test++){
+		benchMeasure(test->run,&result);
+		benchPrint(test->name,&result);
+	}
+}
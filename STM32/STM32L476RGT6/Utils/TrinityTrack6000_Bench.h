@@ -0,0 +1,140 @@
+/**
+ * @file TrinityTrack6000_Bench.h
+ * @brief Micro-benchmark harness for TrinityTrack6000 project.
+ *
+ * Kernels register themselves with `BENCH(name)`, a function body placed
+ * next to a `BenchCase` in the `bench_registry` linker section, no table is
+ * edited by hand. The linker script keeps the section and exports its
+ * bounds, a host link creates `__start_bench_registry` and
+ * `__stop_bench_registry` by itself.
+ *
+ * `benchRunAll()` runs every registered kernel:
+ * - `BENCH_WARMUP` calls which are not recorded (caches, branch predictor)
+ * - `BENCH_ITERATIONS` calls, each one timed alone, with interrupts masked
+ *   on the target
+ * - measurement overhead (timer reads and the indirect call) is calibrated
+ *   first with an empty kernel, its minimum is subtracted from every sample
+ * - min, median, max, mean and standard deviation of the samples
+ *
+ * Inputs which the compiler could fold are passed through `BENCH_OPAQUE()`
+ * and results through `BENCH_KEEP()`, empty asm statements the optimizer
+ * cannot see through, so the kernel is neither constant folded nor removed.
+ *
+ * Every kernel prints one machine-readable line, `Scripts/bench_compare.py`
+ * compares two captures:
+ *
+ *     BENCH <name> <unit> n=<N> min=<> med=<> max=<> mean=<>.<> sd=<>.<> ovh=<>
+ *
+ * The unit is `cyc` (DWT CYCCNT) on the target and `ns` (CLOCK_MONOTONIC)
+ * on the host. The harness and the kernels in TrinityTrack6000_BenchKernels.c
+ * are plain C and build for the host with `BENCH_HOST`:
+ *
+ *     gcc -O2 -DBENCH_HOST -IUtils Scripts/bench_host.c Utils/TrinityTrack6000_Bench.c \
+ *         Utils/TrinityTrack6000_BenchKernels.c Utils/TrinityTrack6000_Format.c -o bench_host
+ *     ./bench_host
+ *
+ * @date 2025.09.25
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_BENCH_H_
+    #define _TRINITYTRACK6000_BENCH_H_
+
+#include <stdint.h>
+
+#ifndef BENCH_ITERATIONS
+    #define BENCH_ITERATIONS 63 /**< Timed calls per kernel, odd for a true median */
+#endif
+#ifndef BENCH_WARMUP
+    #define BENCH_WARMUP 8      /**< Untimed calls before the timed ones */
+#endif
+
+#ifdef BENCH_HOST
+    #define BENCH_UNIT "ns"
+#else
+    #define BENCH_UNIT "cyc"
+#endif
+
+/**
+ * @brief Registered kernel, in the `bench_registry` section
+ */
+typedef struct{
+    const char*name;  /**< Kernel name */
+    void(*run)(void); /**< One call is one sample */
+}BenchCase;
+
+/**
+ * @brief Define and register a kernel.
+ *
+ *     BENCH(div_f32){
+ *         float x=2.71f;
+ *         BENCH_OPAQUE_FLOAT(x);
+ *         ...
+ *     }
+ */
+#define BENCH(name) \
+    static void benchKernel_##name(void); \
+    static const BenchCase bench_case_##name __attribute__((section("bench_registry"),used))={#name,benchKernel_##name}; \
+    static void benchKernel_##name(void)
+
+/** @name Compiler barriers
+ *  @{
+ */
+#define BENCH_OPAQUE(value) __asm volatile("" : "+r"(value))        /**< Value is unknown to the optimizer */
+#define BENCH_KEEP(value)   __asm volatile("" : : "r"(value))        /**< Value is used */
+#define BENCH_CLOBBER()     __asm volatile("" : : : "memory")       /**< Memory is read and written */
+#if defined(__ARM_FP)
+    #define BENCH_FLOAT_REGISTER "t"                                 /**< VFP register, no transfer to a core register */
+#elif defined(__x86_64__)||defined(__i386__)
+    #define BENCH_FLOAT_REGISTER "x"
+#else
+    #define BENCH_FLOAT_REGISTER "g"
+#endif
+#define BENCH_OPAQUE_FLOAT(value) __asm volatile("" : "+" BENCH_FLOAT_REGISTER(value))
+#define BENCH_KEEP_FLOAT(value)   __asm volatile("" : : BENCH_FLOAT_REGISTER(value))
+/** @} */
+
+/**
+ * @brief Statistics of one kernel, in `BENCH_UNIT`
+ */
+typedef struct{
+    uint32_t min;        /**< Fastest sample */
+    uint32_t median;     /**< Middle sample */
+    uint32_t max;        /**< Slowest sample */
+    uint32_t mean100;    /**< Mean in hundredths */
+    uint32_t stddev100;  /**< Population standard deviation in hundredths */
+}BenchResult;
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Measure one kernel.
+ * @param run Kernel
+ * @param result Statistics after overhead subtraction
+ */
+void benchMeasure(void(*run)(void),BenchResult*result);
+
+/**
+ * @brief Measure the overhead subtracted by `benchMeasure()`.
+ */
+void benchCalibrate(void);
+
+/**
+ * @brief Print the `BENCH` line of one kernel.
+ * @param name Kernel name
+ * @param result Statistics from `benchMeasure()`
+ */
+void benchPrint(const char*name,const BenchResult*result);
+
+/**
+ * @brief Calibrate the overhead, measure every registered kernel and print
+ * one line per kernel.
+ */
+void benchRunAll(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_BENCH_H_
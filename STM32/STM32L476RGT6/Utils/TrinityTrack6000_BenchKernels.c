@@ -0,0 +1,71 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <TrinityTrack6000_Bench.h>
+#include <TrinityTrack6000_Format.h>
+
+#define BENCH_BUFFER_SIZE 256
+
+static uint8_t benchKernels_source[BENCH_BUFFER_SIZE];
+static uint8_t benchKernels_destination[BENCH_BUFFER_SIZE];
+static char benchKernels_line[96];
+
+// Single precision division, VDIV.F32 on the target (was the cycle test in main)
+BENCH(div_f32){
+	float x=2.71f;
+	float y=3.14f;
+	float z;
+
+	BENCH_OPAQUE_FLOAT(x);
+	BENCH_OPAQUE_FLOAT(y);
+	z=x/y;
+	BENCH_KEEP_FLOAT(z);
+}
+
+// Integer division, UDIV takes 2 to 12 cycles depending on the operands
+BENCH(div_u32){
+	uint32_t x=1000000007U;
+	uint32_t y=37U;
+
+	BENCH_OPAQUE(x);
+	BENCH_OPAQUE(y);
+	x=x/y;
+	BENCH_KEEP(x);
+}
+
+// CRC-16/CCITT-FALSE, the kernel of TrinityTrack6000_RamBench.c from flash
+BENCH(crc16_256){
+	const uint8_t*data=benchKernels_source;
+	uint16_t length=BENCH_BUFFER_SIZE;
+	uint16_t crc=0xFFFF;
+
+	BENCH_OPAQUE(data);
+	while(length--){
+		crc^=(uint16_t)(*data++<<8);
+		for(uint8_t bit=0;bit<8;bit++){
+			crc=(crc&0x8000)?(uint16_t)((crc<<1)^0x1021):(uint16_t)(crc<<1);
+		}
+	}
+	BENCH_KEEP(crc);
+}
+
+BENCH(memcpy_256){
+	uint8_t*destination=benchKernels_destination;
+
+	BENCH_OPAQUE(destination);
+	memcpy(destination,benchKernels_source,BENCH_BUFFER_SIZE);
+	BENCH_CLOBBER();
+}
+
+// One line of the RAM diagnostics table
+BENCH(format_line){
+	uint32_t start=0x20000000U;
+	uint32_t end=0x20017FFFU;
+	uint16_t length;
+
+	BENCH_OPAQUE(start);
+	BENCH_OPAQUE(end);
+	length=formatString(benchKernels_line,sizeof(benchKernels_line),"| RAM1   | 0x%08lX | 0x%08lX | %3lu  KB |\r\n",
+		(unsigned long)start,(unsigned long)end,(unsigned long)((end-start+1)/1024));
+	BENCH_KEEP(length);
+}
@@ -0,0 +1,156 @@
+#include <stdint.h>
+#include <stm32l4xx_hal.h>
+#include <core_cm4.h>
+
+#include <main.h>
+#include <TrinityTrack6000_Boot.h>
+#include <TrinityTrack6000_Init.h>
+#include <TrinityTrack6000_Crash.h>
+#include <TrinityTrack6000_Clock.h>
+#include <TrinityTrack6000_Idle.h>
+#include <TrinityTrack6000_MemInfo.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Format.h>
+
+#define BOOT_ENTRY(id,entry,kind) {#id,entry,BOOT_KIND_##kind},
+
+const BootStage boot_stages[BOOT_COUNT]={
+	BOOT_STAGES(BOOT_ENTRY)
+};
+
+uint32_t boot_startupMicros;
+uint32_t boot_stageStart[BOOT_COUNT];
+uint32_t boot_stageMicros[BOOT_COUNT];
+uint32_t boot_firstCycleMicros;
+uint32_t boot_doneMicros;
+
+static uint32_t boot_lastCycles; // CYCCNT at the last mark
+static uint32_t boot_lastHz;     // SystemCoreClock at the last mark
+static uint32_t boot_micros;     // Microseconds from reset to the last mark
+static uint32_t boot_loopTick;   // HAL_GetTick() at the end of the first main loop cycle
+static uint8_t boot_next=0;      // Next stage considered by bootDeferred()
+static uint8_t boot_looping=0;
+static uint8_t boot_done=0;
+
+MESSAGE_DEFINE(msg_boot_header1,"+------------------[ BOOT TIMELINE ]-------------------+\r\n");
+MESSAGE_DEFINE(msg_boot_header2,"| #  | Stage       | Kind     | Start [us] | Time [us] |\r\n");
+MESSAGE_DEFINE(msg_boot_header3,"+----+-------------+----------+------------+-----------+\r\n");
+                            //  | 12 | diagnostics | deferred | 1234567890 | 123456789 |
+static const char msg_boot_formatStringStartup[]="| -- | %-11s | %-8s | %10lu | %9lu |\r\n";
+static const char msg_boot_formatStringStage[]  ="| %2u | %-11s | %-8s | %10lu | %9lu |\r\n";
+static const char msg_boot_formatStringCycle[]  ="| First cycle %8lu us, budget %8lu us, %-4s    |\r\n";
+static const char msg_boot_formatStringDone[]   ="| Deferred stages done at %8lu us                  |\r\n";
+
+// Microseconds from reset to now, every clock profile is a whole number of MHz
+static uint32_t bootElapsed(void){
+	uint32_t now=DWT->CYCCNT;
+
+	if(SystemCoreClock!=boot_lastHz){
+		// The clock changed since the last mark, the switch timed itself
+		boot_micros+=clock_switchMicrosLast;
+		boot_lastHz=SystemCoreClock;
+	}
+	else{
+		boot_micros+=(now-boot_lastCycles)/(boot_lastHz/1000000U);
+	}
+	boot_lastCycles=now;
+	return boot_micros;
+}
+
+static void bootRun(uint8_t id){
+	uint32_t start;
+	uint32_t cycles;
+
+	if(!boot_looping){
+		start=bootElapsed();
+		boot_stages[id].entry();
+		boot_stageStart[id]=start;
+		boot_stageMicros[id]=bootElapsed()-start;
+		return;
+	}
+	// CYCCNT stops while the loop sleeps, deferred stages start on the ms tick
+	start=boot_firstCycleMicros+(HAL_GetTick()-boot_loopTick)*1000U;
+	cycles=DWT->CYCCNT;
+	boot_stages[id].entry();
+	boot_stageStart[id]=start;
+	boot_stageMicros[id]=(DWT->CYCCNT-cycles)/(SystemCoreClock/1000000U);
+}
+
+void bootCritical(void){
+	// Startup runs on the reset clock, counted from the first Reset_Handler instruction
+	uint32_t startup=initialize_cyclesToMain/(SystemCoreClock/1000000U);
+
+	boot_lastCycles=initialize_cyclesToMain;
+	boot_lastHz=SystemCoreClock;
+	boot_micros=startup;
+
+	// Nothing in RAM2 is written before the first stage checked it
+	for(uint8_t id=0;id<BOOT_COUNT;id++){
+		if(boot_stages[id].kind==BOOT_KIND_CRITICAL){
+			bootRun(id);
+		}
+	}
+	boot_startupMicros=startup;
+}
+
+uint8_t bootDeferred(void){
+	if(boot_done){
+		return 0;
+	}
+	if(!boot_looping){
+		boot_firstCycleMicros=bootElapsed();
+		boot_loopTick=HAL_GetTick();
+		boot_looping=1;
+		return 1;
+	}
+	if(!uartTxIsIdle()){
+		return 1;
+	}
+	while(boot_next<BOOT_COUNT&&boot_stages[boot_next].kind!=BOOT_KIND_DEFERRED){
+		boot_next++;
+	}
+	if(boot_next<BOOT_COUNT){
+		bootRun(boot_next);
+		boot_doneMicros=boot_stageStart[boot_next]+boot_stageMicros[boot_next];
+		boot_next++;
+		return 1;
+	}
+	boot_done=1;
+	bootReport();
+	return 0;
+}
+
+void bootReport(void){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	uint16_t length;
+
+	if(buffer==NULL){
+		return;
+	}
+	uartTxWriteMessage(&msg_boot_header1);
+	uartTxWriteMessage(&msg_boot_header2);
+	uartTxWriteMessage(&msg_boot_header3);
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_boot_formatStringStartup,"reset","startup",0UL,boot_startupMicros);
+	uartTxWrite((const uint8_t*)buffer,length);
+	for(uint8_t id=0;id<BOOT_COUNT;id++){
+		const BootStage*stage=&boot_stages[id];
+
+		length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_boot_formatStringStage,
+			id,                                                               // Stage number
+			stage->name,                                                      // Stage name
+			(stage->kind==BOOT_KIND_CRITICAL)?"critical":"deferred",          // Stage kind
+			boot_stageStart[id],                                              // From reset
+			boot_stageMicros[id]                                              // Length
+		);
+		uartTxWrite((const uint8_t*)buffer,length);
+	}
+	uartTxWriteMessage(&msg_boot_header3);
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_boot_formatStringCycle,boot_firstCycleMicros,(uint32_t)BOOT_FIRST_CYCLE_BUDGET_US,
+		(boot_firstCycleMicros<=BOOT_FIRST_CYCLE_BUDGET_US)?"OK":"OVER");
+	uartTxWrite((const uint8_t*)buffer,length);
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_boot_formatStringDone,boot_doneMicros);
+	uartTxWrite((const uint8_t*)buffer,length);
+	uartTxWriteMessage(&msg_boot_header3);
+	arenaRelease(&arena_scratch,mark);
+}
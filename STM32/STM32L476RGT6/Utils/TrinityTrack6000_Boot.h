@@ -0,0 +1,95 @@
+/**
+ * @file TrinityTrack6000_Boot.h
+ * @brief Boot stages and boot time profiler for TrinityTrack6000 project.
+ *
+ * Initialization is split into stages declared by `BOOT_STAGES` in
+ * TrinityTrack6000_Config.h. Every stage is one function and a kind:
+ * - `CRITICAL` stages run in order from `initializeSystem()` before the
+ *   main loop, only what the loop needs (clock, UART, pools, tasks)
+ * - `DEFERRED` stages run from `bootDeferred()`, one per main loop cycle
+ *   after the first one, only when the UART transmitter is idle, so banners,
+ *   reports and benchmarks neither delay the loop nor overrun each other
+ *
+ * Time is taken from DWT CYCCNT, which startup enables with the first
+ * Reset_Handler instruction. Cycles are converted to microseconds with the
+ * clock they ran on, a stage which switches the clock is timed by
+ * `clockSwitch()` (`clock_switchMicrosLast`). Once the loop runs the core
+ * sleeps between cycles and CYCCNT stops with it (see TrinityTrack6000_Idle.h),
+ * deferred stages start on the millisecond tick and are timed by CYCCNT.
+ * The timeline starts at reset: startup to main, start and length of every
+ * stage, the end of the first main loop cycle (time to first control cycle)
+ * and the end of the deferred work. It is printed by `bootReport()` once the last deferred stage is
+ * done, the first cycle is checked against `BOOT_FIRST_CYCLE_BUDGET_US`.
+ *
+ * @date 2025.09.23
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_BOOT_H_
+    #define _TRINITYTRACK6000_BOOT_H_
+
+#include <stdint.h>
+
+#include <TrinityTrack6000_Config.h>
+#include <TrinityTrack6000_Placement.h>
+
+#define BOOT_KIND_CRITICAL 0 /**< Runs before the main loop */
+#define BOOT_KIND_DEFERRED 1 /**< Runs from the main loop */
+
+/**
+ * @brief Boot stage, in flash
+ */
+typedef struct{
+    const char*name;    /**< Stage name */
+    void(*entry)(void); /**< Stage function */
+    uint8_t kind;       /**< BOOT_KIND_x */
+}BootStage;
+
+#define BOOT_ID(id,entry,kind) BOOT_##id,
+
+enum{
+    BOOT_STAGES(BOOT_ID)
+    BOOT_COUNT
+};
+
+extern const BootStage boot_stages[BOOT_COUNT]; /**< Stage table, in `BOOT_STAGES` order */
+
+/**
+ * @brief Boot timeline in microseconds from reset, kept in RAM2
+ * @{
+ */
+extern uint32_t boot_startupMicros             RAM2_DIAG(boot_startupMicros);    /**< Reset_Handler to main */
+extern uint32_t boot_stageStart[BOOT_COUNT]    RAM2_DIAG(boot_stageStart);       /**< Start of every stage */
+extern uint32_t boot_stageMicros[BOOT_COUNT]   RAM2_DIAG(boot_stageMicros);      /**< Length of every stage */
+extern uint32_t boot_firstCycleMicros          RAM2_DIAG(boot_firstCycleMicros); /**< End of the first main loop cycle */
+extern uint32_t boot_doneMicros                RAM2_DIAG(boot_doneMicros);       /**< End of the last deferred stage */
+/** @} */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Run the critical stages.
+ */
+void bootCritical(void);
+
+/**
+ * @brief Advance the deferred stages, called once per main loop cycle.
+ *
+ * The first call marks the end of the first control cycle. Later calls
+ * run the next deferred stage when the UART transmitter is idle, the one
+ * after the last stage prints the timeline.
+ * @return 0 when every deferred stage is done
+ */
+uint8_t bootDeferred(void);
+
+/**
+ * @brief Print the boot timeline.
+ */
+void bootReport(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_BOOT_H_
@@ -0,0 +1,204 @@
+#include <stdint.h>
+#include <stm32l4xx_hal.h>
+#include <core_cm4.h>
+
+#include <main.h>
+#include <TrinityTrack6000_Clock.h>
+#include <TrinityTrack6000_Errors.h>
+#include <TrinityTrack6000_MemInfo.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Format.h>
+
+#define CLOCK_ENTRY(id,sysclk,source,msiRange,pllN,voltageScale,flashLatency) \
+	{#id,(sysclk),CLOCK_SOURCE_##source,(msiRange),(pllN),(voltageScale),(flashLatency)},
+
+const ClockProfile clock_profiles[CLOCK_COUNT]={
+	CLOCK_PROFILES(CLOCK_ENTRY)
+};
+
+uint8_t clock_current=CLOCK_NONE;
+
+uint32_t clock_switches[CLOCK_COUNT];
+uint32_t clock_switchMicrosMax[CLOCK_COUNT];
+uint32_t clock_drainMicrosLast;
+uint32_t clock_switchMicrosLast;
+uint32_t clock_lostCyclesLast;
+uint32_t clock_drainTimeouts;
+
+static ClockCallback clock_callbacks[CLOCK_CALLBACKS_MAX];
+static uint8_t clock_callbackCount=0;
+
+MESSAGE_DEFINE(msg_clock_header1,"+------------------[ CLOCK PROFILES ]------------------+\r\n");
+MESSAGE_DEFINE(msg_clock_header2,"| #  | Profile     | MHz | VOS | WS | Count | Max [us] |\r\n");
+MESSAGE_DEFINE(msg_clock_header3,"+----+-------------+-----+-----+----+-------+----------+\r\n");
+                             //  | *1 | performance |  80 |   1 |  4 | 12345 | 12345678 |
+static const char msg_clock_formatStringProfile[]="| %c%u | %-11s | %3lu | %3u | %2lu | %5lu | %8lu |\r\n";
+static const char msg_clock_formatStringLast[]   ="| Last switch: drain %7lu us, switch %7lu us     |\r\n";
+static const char msg_clock_formatStringLost[]   ="| Lost %9lu cycles, drain timeouts %7lu        |\r\n";
+
+static void clockCheck(HAL_StatusTypeDef status,uint32_t error){
+	if(status!=HAL_OK){
+		global_error_code=error;
+		Error_Handler();
+	}
+}
+
+static void clockNotify(ClockPhase phase){
+	for(uint8_t i=0;i<clock_callbackCount;i++){
+		clock_callbacks[i](phase);
+	}
+}
+
+// Cycles counted on a clock of hz, every profile is a whole number of MHz
+static uint32_t clockMicros(uint32_t cycles,uint32_t hz){
+	return cycles/(hz/1000000U);
+}
+
+static void clockOscillators(const ClockProfile*profile){
+	RCC_OscInitTypeDef oscillators={0};
+
+	if(profile->source==RCC_SYSCLKSOURCE_PLLCLK){
+		oscillators.OscillatorType=RCC_OSCILLATORTYPE_HSI;
+		oscillators.HSIState=RCC_HSI_ON;
+		oscillators.HSICalibrationValue=RCC_HSICALIBRATION_DEFAULT;
+		oscillators.PLL.PLLState=RCC_PLL_ON;
+		oscillators.PLL.PLLSource=RCC_PLLSOURCE_HSI;
+		oscillators.PLL.PLLM=1;
+		oscillators.PLL.PLLN=profile->pllN;
+		oscillators.PLL.PLLP=RCC_PLLP_DIV7;
+		oscillators.PLL.PLLQ=RCC_PLLQ_DIV2;
+		oscillators.PLL.PLLR=RCC_PLLR_DIV2;
+	}
+	else{
+		oscillators.OscillatorType=RCC_OSCILLATORTYPE_MSI;
+		oscillators.MSIState=RCC_MSI_ON;
+		oscillators.MSICalibrationValue=RCC_MSICALIBRATION_DEFAULT;
+		oscillators.MSIClockRange=profile->msiRange;
+		oscillators.PLL.PLLState=RCC_PLL_NONE;
+	}
+	clockCheck(HAL_RCC_OscConfig(&oscillators),ERROR_HAL_RCC_OscConfig);
+}
+
+// Stops the oscillators the new profile does not run from
+static void clockStopUnused(const ClockProfile*profile){
+	if(profile->source==RCC_SYSCLKSOURCE_PLLCLK){
+		__HAL_RCC_MSI_DISABLE();
+		return;
+	}
+	__HAL_RCC_PLL_DISABLE();
+	while(__HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY)){
+	}
+	__HAL_RCC_HSI_DISABLE();
+}
+
+HAL_StatusTypeDef clockRegister(ClockCallback callback){
+	if(clock_callbackCount>=CLOCK_CALLBACKS_MAX){
+		return HAL_ERROR;
+	}
+	clock_callbacks[clock_callbackCount++]=callback;
+	return HAL_OK;
+}
+
+void clockSwitch(uint8_t profile){
+	const ClockProfile*target=&clock_profiles[profile];
+	RCC_ClkInitTypeDef buses={0};
+	uint32_t oldHz=SystemCoreClock;
+	uint32_t start;
+	uint32_t prepared;
+	uint32_t switched;
+	uint32_t end;
+	uint32_t micros;
+
+	if(profile>=CLOCK_COUNT||profile==clock_current){
+		return;
+	}
+	CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL|=DWT_CTRL_CYCCNTENA_Msk;
+
+	start=DWT->CYCCNT;
+	clockNotify(CLOCK_PHASE_PREPARE);
+	prepared=DWT->CYCCNT;
+
+	// Range 1 before the clock goes up
+	if(target->voltageScale==PWR_REGULATOR_VOLTAGE_SCALE1){
+		clockCheck(HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE1),ERROR_HAL_PWREx_ControlVoltageScaling);
+	}
+	clockOscillators(target);
+
+	// Wait states follow the clock, SysTick is reloaded from the new HCLK
+	buses.ClockType=RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK|RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2;
+	buses.SYSCLKSource=target->source;
+	buses.AHBCLKDivider=RCC_SYSCLK_DIV1;
+	buses.APB1CLKDivider=RCC_HCLK_DIV1;
+	buses.APB2CLKDivider=RCC_HCLK_DIV1;
+	clockCheck(HAL_RCC_ClockConfig(&buses,target->flashLatency),ERROR_HAL_RCC_ClockConfig);
+	switched=DWT->CYCCNT;
+	// Stop 2 ends on HSI16 for the PLL, clockResume() restarts it
+	__HAL_RCC_WAKEUPSTOP_CLK_CONFIG((target->source==RCC_SYSCLKSOURCE_PLLCLK)?RCC_STOP_WAKEUPCLOCK_HSI:RCC_STOP_WAKEUPCLOCK_MSI);
+
+	clockStopUnused(target);
+	// Range 2 after the clock went down
+	if(target->voltageScale!=PWR_REGULATOR_VOLTAGE_SCALE1){
+		clockCheck(HAL_PWREx_ControlVoltageScaling(target->voltageScale),ERROR_HAL_PWREx_ControlVoltageScaling);
+	}
+	clock_current=profile;
+	clockNotify(CLOCK_PHASE_RETIME);
+	end=DWT->CYCCNT;
+
+	clock_drainMicrosLast=clockMicros(prepared-start,oldHz);
+	micros=clockMicros(switched-start,oldHz)+clockMicros(end-switched,target->sysclk);
+	clock_switchMicrosLast=micros;
+	clock_lostCyclesLast=micros*(target->sysclk/1000000U);
+	clock_switches[profile]++;
+	if(micros>clock_switchMicrosMax[profile]){
+		clock_switchMicrosMax[profile]=micros;
+	}
+}
+
+void clockResume(void){
+	// MSI keeps its range over Stop 2, the PLL and its configuration only wait for PLLON
+	if(clock_current>=CLOCK_COUNT||clock_profiles[clock_current].source!=RCC_SYSCLKSOURCE_PLLCLK){
+		return;
+	}
+	__HAL_RCC_PLL_ENABLE();
+	while(!__HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY)){
+	}
+	__HAL_RCC_SYSCLK_CONFIG(RCC_SYSCLKSOURCE_PLLCLK);
+	while(__HAL_RCC_GET_SYSCLK_SOURCE()!=RCC_SYSCLKSOURCE_STATUS_PLLCLK){
+	}
+}
+
+void clockReport(void){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	uint16_t length;
+
+	if(buffer==NULL){
+		return;
+	}
+	uartTxWriteMessage(&msg_clock_header1);
+	uartTxWriteMessage(&msg_clock_header2);
+	uartTxWriteMessage(&msg_clock_header3);
+	for(uint8_t id=0;id<CLOCK_COUNT;id++){
+		const ClockProfile*profile=&clock_profiles[id];
+
+		length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_clock_formatStringProfile,
+			(id==clock_current)?'*':' ',                                      // Active profile marker
+			id+1,                                                             // Argument of command c
+			profile->name,                                                    // Profile name
+			profile->sysclk/1000000U,                                         // SYSCLK in MHz
+			(profile->voltageScale==PWR_REGULATOR_VOLTAGE_SCALE1)?1U:2U,      // Regulator range
+			profile->flashLatency,                                            // Flash wait states
+			clock_switches[id],                                               // Switches into profile
+			clock_switchMicrosMax[id]                                         // Longest switch
+		);
+		uartTxWrite((const uint8_t*)buffer,length);
+	}
+	uartTxWriteMessage(&msg_clock_header3);
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_clock_formatStringLast,clock_drainMicrosLast,clock_switchMicrosLast);
+	uartTxWrite((const uint8_t*)buffer,length);
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_clock_formatStringLost,clock_lostCyclesLast,clock_drainTimeouts);
+	uartTxWrite((const uint8_t*)buffer,length);
+	uartTxWriteMessage(&msg_clock_header3);
+	arenaRelease(&arena_scratch,mark);
+}
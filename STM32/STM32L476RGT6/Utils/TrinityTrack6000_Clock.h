@@ -0,0 +1,139 @@
+/**
+ * @file TrinityTrack6000_Clock.h
+ * @brief Runtime switchable clock profiles for TrinityTrack6000 project.
+ *
+ * Clock profiles are defined at compile time by `CLOCK_PROFILES` in
+ * TrinityTrack6000_Config.h: system clock, source (HSI16 through the PLL or
+ * MSI), regulator range and flash wait states. The first profile is applied
+ * at boot by `initializeClock()`. Defaults:
+ * - `performance` 80 MHz from the PLL, range 1, 4 wait states
+ * - `balanced` 24 MHz MSI, range 2, 3 wait states
+ * - `lowPower` 4 MHz MSI, range 2, no wait states
+ *
+ * `clockSwitch()` keeps the order the reference manual requires: range 1
+ * is selected before the clock goes up, range 2 after it went down. The
+ * wait states are raised before and lowered after the switch by
+ * `HAL_RCC_ClockConfig()`, which also reloads SysTick for the new HCLK.
+ * Oscillators not used by the new profile are stopped, the wakeup clock
+ * from Stop 2 is selected for `clockResume()`.
+ *
+ * Peripherals whose timing depends on a bus clock register a callback with
+ * `clockRegister()`. It is called twice per switch:
+ * - `CLOCK_PHASE_PREPARE` on the old clock, finish or pause transfers
+ * - `CLOCK_PHASE_RETIME` on the new clock, reload prescalers and baud rates
+ *
+ * Every switch is measured with DWT CYCCNT. Cycles are converted to
+ * microseconds with the clock they ran on: prepare and oscillator setup on
+ * the old clock, the rest on the new one. `clock_lostCyclesLast` is the
+ * whole switch expressed in cycles of the new clock, the work the loop
+ * could have done instead. `clockReport()` prints the profile table
+ * (command `c`, `c1`... switch to a profile).
+ *
+ * @date 2025.09.22
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_CLOCK_H_
+    #define _TRINITYTRACK6000_CLOCK_H_
+
+#include <stdint.h>
+#include <stm32l4xx_hal.h>
+
+#include <TrinityTrack6000_Config.h>
+#include <TrinityTrack6000_Placement.h>
+
+/** @name Clock sources, third argument of `CLOCK_PROFILES`
+ *  @{
+ */
+#define CLOCK_SOURCE_PLL RCC_SYSCLKSOURCE_PLLCLK
+#define CLOCK_SOURCE_MSI RCC_SYSCLKSOURCE_MSI
+/** @} */
+
+/**
+ * @brief Phase of a clock profile switch passed to callbacks
+ */
+typedef enum{
+    CLOCK_PHASE_PREPARE, /**< Before the switch, old clock */
+    CLOCK_PHASE_RETIME   /**< After the switch, new clock */
+}ClockPhase;
+
+typedef void(*ClockCallback)(ClockPhase phase); /**< Peripheral retiming callback */
+
+/**
+ * @brief Clock profile, in flash
+ */
+typedef struct{
+    const char*name;       /**< Profile name */
+    uint32_t sysclk;       /**< SYSCLK in Hz, HCLK and PCLKs run undivided */
+    uint32_t source;       /**< RCC_SYSCLKSOURCE_PLLCLK or RCC_SYSCLKSOURCE_MSI */
+    uint32_t msiRange;     /**< RCC_MSIRANGE_x, MSI profiles */
+    uint32_t pllN;         /**< PLL multiplier of HSI16, PLL profiles */
+    uint32_t voltageScale; /**< PWR_REGULATOR_VOLTAGE_SCALEx */
+    uint32_t flashLatency; /**< FLASH_LATENCY_x */
+}ClockProfile;
+
+#define CLOCK_ID(id,sysclk,source,msiRange,pllN,voltageScale,flashLatency) CLOCK_##id,
+
+enum{
+    CLOCK_PROFILES(CLOCK_ID)
+    CLOCK_COUNT
+};
+
+#define CLOCK_NONE 0xFF /**< `clock_current` before the boot profile is applied */
+
+extern const ClockProfile clock_profiles[CLOCK_COUNT]; /**< Profile table, in `CLOCK_PROFILES` order */
+
+extern uint8_t clock_current; /**< Active profile */
+
+/**
+ * @brief Clock switch statistics, kept in RAM2
+ * @{
+ */
+extern uint32_t clock_switches[CLOCK_COUNT]        RAM2_DIAG(clock_switches);         /**< Switches into every profile */
+extern uint32_t clock_switchMicrosMax[CLOCK_COUNT] RAM2_DIAG(clock_switchMicrosMax);  /**< Longest switch into every profile */
+extern uint32_t clock_drainMicrosLast              RAM2_DIAG(clock_drainMicrosLast);  /**< Prepare callbacks of last switch */
+extern uint32_t clock_switchMicrosLast             RAM2_DIAG(clock_switchMicrosLast); /**< Last switch, prepare to retime done */
+extern uint32_t clock_lostCyclesLast               RAM2_DIAG(clock_lostCyclesLast);   /**< Last switch in cycles of the new clock */
+extern uint32_t clock_drainTimeouts                RAM2_DIAG(clock_drainTimeouts);    /**< Switches done with output still pending */
+/** @} */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Register a peripheral retiming callback.
+ * @param callback Called with both phases on every switch
+ * @return HAL_ERROR when `CLOCK_CALLBACKS_MAX` callbacks are registered
+ */
+HAL_StatusTypeDef clockRegister(ClockCallback callback);
+
+/**
+ * @brief Switch to a clock profile.
+ *
+ * Runs in thread context with interrupts enabled, HAL timeouts need
+ * SysTick. A HAL failure leaves the clock tree undefined and ends in
+ * `Error_Handler()`.
+ * @param profile CLOCK_<id>
+ */
+void clockSwitch(uint8_t profile);
+
+/**
+ * @brief Restore the active profile after Stop 2.
+ *
+ * Stop 2 stops the PLL and wakes on HSI16 (PLL profiles) or MSI at its
+ * range (MSI profiles). Regulator range, wait states and bus dividers are
+ * kept, so only the PLL is restarted and selected. Called by tickless idle
+ * with interrupts masked.
+ */
+void clockResume(void);
+
+/**
+ * @brief Print the profile table with switch statistics.
+ */
+void clockReport(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_CLOCK_H_
@@ -0,0 +1,149 @@
+#include <stdint.h>
+
+#include <TrinityTrack6000_Commands.h>
+#include <TrinityTrack6000_MemInfo.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Telemetry.h>
+#include <TrinityTrack6000_MemHistory.h>
+#include <TrinityTrack6000_MemTrace.h>
+#include <TrinityTrack6000_Pool.h>
+#include <TrinityTrack6000_Task.h>
+#include <TrinityTrack6000_Clock.h>
+#include <TrinityTrack6000_Idle.h>
+
+MESSAGE_DEFINE(msg_commands_unknown,"| Unknown command, use s(snapshot) b(bank) h(history) a(allocs) k(tasks) c(clock) t(telemetry) q(quit)\r\n");
+MESSAGE_DEFINE(msg_commands_quit,   "| Diagnostics session closed, s(snapshot) to reopen\r\n");
+
+static volatile uint8_t commands_pending=COMMAND_NONE;
+static volatile uint8_t commands_pendingArgument=0;
+
+static uint8_t commands_sessionActive=1;
+static uint8_t commands_lastBank=MEMINFO_BANK_COUNT; // Bank 1 (first) is shown by plain b
+
+uint32_t commands_dropped=0;
+
+void commandsLineReceived(const char*line,uint8_t length){
+	uint8_t command=COMMAND_UNKNOWN;
+	uint8_t argument=0;
+
+	// Leading spaces are sent by some terminals
+	while(length>0&&*line==' '){
+		line++;
+		length--;
+	}
+	if(length==0){
+		return;
+	}
+	if(commands_pending!=COMMAND_NONE){
+		commands_dropped++;
+		return;
+	}
+
+	switch(line[0]){
+		case COMMAND_SNAPSHOT:
+		case COMMAND_HISTORY:
+		case COMMAND_ALLOCATIONS:
+		case COMMAND_TASKS:
+		case COMMAND_TELEMETRY:
+		case COMMAND_QUIT:
+			if(length==1){
+				command=(uint8_t)line[0];
+			}
+			break;
+		case COMMAND_BANK:
+			if(length==1){
+				command=COMMAND_BANK;
+			}
+			else if(length==2&&line[1]>='1'&&line[1]<'1'+MEMINFO_BANK_COUNT){
+				command=COMMAND_BANK;
+				argument=(uint8_t)(line[1]-'0');
+			}
+			break;
+		case COMMAND_CLOCK:
+			if(length==1){
+				command=COMMAND_CLOCK;
+			}
+			else if(length==2&&line[1]>='1'&&line[1]<'1'+CLOCK_COUNT){
+				command=COMMAND_CLOCK;
+				argument=(uint8_t)(line[1]-'0');
+			}
+			break;
+		default:
+			break;
+	}
+	commands_pendingArgument=argument;
+	commands_pending=command;
+}
+
+void commandsProcess(void){
+	uint8_t command=commands_pending;
+	uint8_t argument=commands_pendingArgument;
+
+	if(command==COMMAND_NONE){
+		return;
+	}
+	commands_pending=COMMAND_NONE;
+
+	switch(command){
+		case COMMAND_SNAPSHOT:
+			commands_sessionActive=1;
+			ramDiagnosticsRefresh();
+			ramDiagnosticsGeneral();
+			break;
+		case COMMAND_BANK:
+			if(!commands_sessionActive){
+				break;
+			}
+			if(argument==0){
+				argument=(uint8_t)(commands_lastBank%MEMINFO_BANK_COUNT+1);
+			}
+			commands_lastBank=argument;
+			ramDiagnosticsRefresh();
+			ramDiagnosticsBank((uint8_t)(argument-1));
+			break;
+		case COMMAND_HISTORY:
+			if(commands_sessionActive){
+				memHistoryDump();
+			}
+			break;
+		case COMMAND_ALLOCATIONS:
+			if(commands_sessionActive){
+				poolReport();
+				memTraceDump();
+			}
+			break;
+		case COMMAND_TASKS:
+			if(commands_sessionActive){
+				taskReport();
+			}
+			break;
+		case COMMAND_CLOCK:
+			// Switching does not need a session, the table does
+			if(argument!=0){
+				clockSwitch((uint8_t)(argument-1));
+			}
+			if(commands_sessionActive){
+				clockReport();
+				idleReport();
+			}
+			break;
+		case COMMAND_TELEMETRY:
+			if(telemetry_streaming){
+				telemetryStop();
+			}
+			else{
+				telemetryStart();
+			}
+			break;
+		case COMMAND_QUIT:
+			telemetryStop();
+			if(commands_sessionActive){
+				commands_sessionActive=0;
+				uartTxWriteMessage(&msg_commands_quit);
+			}
+			break;
+		default:
+			uartTxWriteMessage(&msg_commands_unknown);
+			break;
+	}
+}
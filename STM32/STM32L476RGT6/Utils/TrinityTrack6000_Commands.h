@@ -0,0 +1,85 @@
+/**
+ * @file TrinityTrack6000_Commands.h
+ * @brief Diagnostics command set for TrinityTrack6000 project.
+ *
+ * Command lines framed by the UART receiver are parsed in interrupt context
+ * into a pending command, which is executed later from the main loop by
+ * `commandsProcess()`. Parsing is a few comparisons, so the receive interrupt
+ * stays short while the reports themselves run in thread context.
+ *
+ * Commands (as advertised by the diagnostics footer):
+ * - `s` snapshot, refreshes memory usage and prints general RAM diagnostics
+ * - `b` bank, prints the next bank details (`b1`, `b2`... select a bank of `MEMINFO_BANKS`)
+ * - `h` history, prints the memory usage time series with min/max/avg (see TrinityTrack6000_MemHistory.h)
+ * - `a` allocations, prints pool usage (see TrinityTrack6000_Pool.h) and traced malloc() call sites (see TrinityTrack6000_MemTrace.h)
+ * - `k` tasks, prints placement, stack high-water mark and run time of every task (see TrinityTrack6000_Task.h)
+ * - `c` clock, prints clock profiles, switch times and idle statistics (`c1`, `c2`... switch to a profile of `CLOCK_PROFILES`, see TrinityTrack6000_Clock.h and TrinityTrack6000_Idle.h)
+ * - `t` telemetry, toggles streaming of binary memory frames (see TrinityTrack6000_Telemetry.h)
+ * - `q` quit, ends the diagnostics session until the next snapshot, stops telemetry
+ *
+ * @date 2025.09.10
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_COMMANDS_H_
+    #define _TRINITYTRACK6000_COMMANDS_H_
+
+#include <stdint.h>
+
+#include <TrinityTrack6000_Message.h>
+
+/** @name Diagnostics command codes
+ *  @{
+ */
+#define COMMAND_NONE     0x00 /**< No command pending */
+#define COMMAND_SNAPSHOT 's'  /**< Refresh and print general RAM diagnostics */
+#define COMMAND_BANK     'b'  /**< Print RAM bank details */
+#define COMMAND_HISTORY  'h'  /**< Print memory usage history */
+#define COMMAND_ALLOCATIONS 'a' /**< Print pool and allocation tracer tables */
+#define COMMAND_TASKS    'k'  /**< Print task table */
+#define COMMAND_CLOCK    'c'  /**< Print or switch clock profiles */
+#define COMMAND_TELEMETRY 't' /**< Toggle binary telemetry streaming */
+#define COMMAND_QUIT     'q'  /**< End diagnostics session */
+#define COMMAND_UNKNOWN  0xFF /**< Line was not recognized */
+/** @} */
+
+/** @name Command responses
+ *  @{
+ */
+extern const Message msg_commands_unknown; /**< Response to unknown command */
+extern const Message msg_commands_quit;    /**< Response to quit command */
+/** @} */
+
+/**
+ * @brief Command parser statistics
+ * @{
+ */
+extern uint32_t commands_dropped; /**< Commands received while previous one was still pending */
+/** @} */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Parse a received command line.
+ *
+ * Called from UART receive interrupt with a NUL terminated line.
+ * The command is stored as pending until `commandsProcess()` executes it.
+ *
+ * @param line Received line without line terminator
+ * @param length Number of characters in line
+ */
+void commandsLineReceived(const char*line,uint8_t length);
+
+/**
+ * @brief Execute pending command.
+ *
+ * Must be called periodically from thread context (main loop).
+ */
+void commandsProcess(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_COMMANDS_H_
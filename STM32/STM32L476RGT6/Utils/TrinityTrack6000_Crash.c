@@ -0,0 +1,79 @@
+#include <stdint.h>
+#include <string.h>
+#include <stm32l4xx_hal.h>
+#include <core_cm4.h>
+
+#include <TrinityTrack6000_Crash.h>
+#include <TrinityTrack6000_Boot.h>
+#include <TrinityTrack6000_Errors.h>
+#include <TrinityTrack6000_Log.h>
+
+CrashRecord crash_record;
+uint8_t crash_warmBoot=0;
+
+static uint32_t crash_cycles=0; // Main loop cycles counted by crashCycle(), up to CRASH_STABLE_CYCLES
+
+uint8_t crashPending(void){
+	return crash_record.magic==CRASH_MAGIC&&crash_record.pending&&(RCC->CSR&RCC_CSR_SFTRSTF)!=0;
+}
+
+void crashInit(void){
+	uint8_t pending=crashPending();
+
+	__HAL_RCC_CLEAR_RESET_FLAGS();
+	if(pending){
+		crash_warmBoot=1;
+		crash_record.pending=0;
+		crash_record.resetCount++;
+		return;
+	}
+	memset(&crash_record,0,sizeof(crash_record));
+	crash_record.magic=CRASH_MAGIC;
+}
+
+void crashRestart(uint32_t start){
+	crash_record.magic=CRASH_MAGIC;
+	crash_record.errorCode=global_error_code;
+	crash_record.cfsr=SCB->CFSR;
+	crash_record.hfsr=SCB->HFSR;
+	crash_record.mmfar=SCB->MMFAR;
+	crash_record.bfar=SCB->BFAR;
+	crash_record.uptime=HAL_GetTick();
+	crash_record.pending=1;
+	// Every clock profile is a whole number of MHz
+	crash_record.handlerMicros=(DWT->CYCCNT-start)/(SystemCoreClock/1000000U);
+	if(crash_record.resetCount>=CRASH_RESTARTS_MAX){
+		// Fault repeats on every boot, stop with interrupts masked, the record stays for the debugger
+		crash_record.pending=0;
+		__DSB();
+		while(1){
+			__WFI();
+		}
+	}
+	__DSB();
+
+	NVIC_SystemReset();
+}
+
+void crashReport(void){
+	if(!crash_warmBoot){
+		return;
+	}
+	LOG_TOKEN("| Warm restart %lu, error 0x%lX at %lu ms\r\n",crash_record.resetCount,crash_record.errorCode,crash_record.uptime);
+	LOG_TOKEN("| CFSR 0x%08lX HFSR 0x%08lX MMFAR 0x%08lX BFAR 0x%08lX\r\n",crash_record.cfsr,crash_record.hfsr,crash_record.mmfar,crash_record.bfar);
+}
+
+void crashCycle(void){
+	if(crash_cycles>=CRASH_STABLE_CYCLES){
+		return;
+	}
+	crash_cycles++;
+	if(crash_cycles==1&&crash_warmBoot){
+		// Boot timeline converts startup and every stage with the clock it ran on
+		crash_record.recoveryMicros=crash_record.handlerMicros+boot_firstCycleMicros;
+		LOG_TOKEN("| Recovered in %lu us, %lu in Error_Handler\r\n",crash_record.recoveryMicros,crash_record.handlerMicros);
+	}
+	if(crash_cycles==CRASH_STABLE_CYCLES){
+		crash_record.resetCount=0; // Only consecutive crashes count towards CRASH_RESTARTS_MAX
+	}
+}
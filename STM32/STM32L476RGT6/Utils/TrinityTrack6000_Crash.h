@@ -0,0 +1,109 @@
+/**
+ * @file TrinityTrack6000_Crash.h
+ * @brief Reset-surviving crash record and warm restart for TrinityTrack6000 project.
+ *
+ * `Error_Handler()` does not stop the system, it stores a crash record and
+ * resets with `NVIC_SystemReset()`. The record lives in the `.noinit`
+ * section at the start of RAM2, which startup neither copies nor zeroes and
+ * a system reset does not clear. It stays at the same address between
+ * builds. RAM2 can also be kept in Standby (PWR_CR3 RRS).
+ *
+ * The record holds a magic tag, error code (`global_error_code`), fault
+ * status registers (CFSR, HFSR, MMFAR, BFAR), uptime and reset count:
+ * - `crashInit()` (a critical boot stage, see TrinityTrack6000_Boot.h)
+ *   tells a warm boot (valid magic, pending crash, software reset flag)
+ *   from a cold one, a cold boot clears the record
+ * - a warm boot shortens the critical path: `initializeCheck()` skips the
+ *   RAM2 check (`crashPending()`, startup zeroed RAM2 as on every boot) and
+ *   `taskInit()` keeps the task frames, which are NOLOAD and survive the
+ *   reset, instead of repainting them (high-water marks carry over)
+ * - `crash_warmBoot` also skips the deferred reports and benchmarks, which
+ *   run after the first control cycle and only shorten the time to the
+ *   end of the deferred work
+ * - after `CRASH_RESTARTS_MAX` consecutive warm restarts `crashRestart()`
+ *   no longer resets, it halts with interrupts masked. `CRASH_STABLE_CYCLES`
+ *   main loop cycles without a crash clear the count
+ * - `crashReport()` logs the record from the boot banner
+ * - `crashCycle()`, called once per main loop cycle, computes the recovery
+ *   time on its first call: microseconds from `Error_Handler()` to the reset
+ *   request plus the end of the first control cycle from the boot timeline
+ *   (see TrinityTrack6000_Boot.h). The hardware reset sequence itself is
+ *   not counted.
+ *
+ * @date 2025.09.21
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_CRASH_H_
+    #define _TRINITYTRACK6000_CRASH_H_
+
+#include <stdint.h>
+
+#include <TrinityTrack6000_Config.h>
+#include <TrinityTrack6000_Placement.h>
+
+#define CRASH_MAGIC 0xC4A5E5ADu /**< Tag of an initialized record */
+
+/**
+ * @brief Crash record, kept over resets
+ */
+typedef struct{
+    uint32_t magic;          /**< CRASH_MAGIC when the record is valid */
+    uint32_t pending;        /**< 1 between Error_Handler() and the next boot */
+    uint32_t errorCode;      /**< global_error_code at the crash */
+    uint32_t cfsr;           /**< Configurable fault status */
+    uint32_t hfsr;           /**< Hard fault status */
+    uint32_t mmfar;          /**< MemManage fault address */
+    uint32_t bfar;           /**< Bus fault address */
+    uint32_t uptime;         /**< HAL tick at the crash in ms */
+    uint32_t resetCount;     /**< Consecutive warm restarts */
+    uint32_t handlerMicros;  /**< Microseconds from Error_Handler() entry to the reset request */
+    uint32_t recoveryMicros; /**< Microseconds from the crash to the first control cycle, last restart */
+}CrashRecord;
+
+extern CrashRecord crash_record RAM2_NOINIT(crash_record); /**< Crash record */
+extern uint8_t crash_warmBoot; /**< 1 when this boot restarts after a crash */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Tell whether this boot restarts after a crash, before `crashInit()`.
+ *
+ * Reads the record and the reset flags only, nothing is written.
+ * @retval 1 when the reset was requested by `crashRestart()`
+ */
+uint8_t crashPending(void);
+
+/**
+ * @brief Check the record and the reset cause.
+ *
+ * Must run before anything may call `Error_Handler()`.
+ */
+void crashInit(void);
+
+/**
+ * @brief Store the crash record and reset, called by `Error_Handler()`.
+ *
+ * Halts instead once `CRASH_RESTARTS_MAX` warm restarts were reached.
+ * @param start DWT CYCCNT at `Error_Handler()` entry
+ */
+void crashRestart(uint32_t start) __attribute__((noreturn));
+
+/**
+ * @brief Log the crash record of a warm boot.
+ */
+void crashReport(void);
+
+/**
+ * @brief Measure and log the recovery time of a warm boot, clear the restart count once stable.
+ *
+ * Called once per main loop cycle, after `bootDeferred()`.
+ */
+void crashCycle(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_CRASH_H_
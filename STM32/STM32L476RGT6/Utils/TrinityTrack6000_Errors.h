@@ -2,11 +2,20 @@
 #ifndef _TRINITY_TRACK6000_ERRORS_H_
     #define _TRINITY_TRACK6000_ERRORS_H_
 
+#include <stdint.h>
+
+#include <TrinityTrack6000_Placement.h>
+
 #define ERROR_HAL_PWREx_ControlVoltageScaling 0x100
 #define ERROR_HAL_RCC_OscConfig               0x101
 #define ERROR_HAL_RCC_ClockConfig             0x102
 #define ERROR_HAL_UART_Init                   0x103
+#define ERROR_HAL_UART_ReceiveToIdle_DMA      0x104
+#define ERROR_CLOCK_CALLBACKS                 0x105 // CLOCK_CALLBACKS_MAX too small
+#define ERROR_TASK_STACK_OVERFLOW             0x200 // Plus task id, guard zone overwritten
+#define ERROR_HARD_FAULT                      0x300
+#define ERROR_MEM_MANAGE                      0x301 // MemManage other than a task stack overflow
 
-extern uint32_t global_error_code __attribute((section(".sysDiag")));
+extern uint32_t global_error_code RAM2_SYSDIAG(global_error_code);
 
 #endif // _TRINITY_TRACK6000_ERRORS_H_
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include <stdint.h>
+#include <stdarg.h>
+
+#include <TrinityTrack6000_Format.h>
+
+static const char format_hexDigits[]="0123456789ABCDEF";
+
+uint16_t formatHex(char*output,uint32_t value,uint8_t digits){
+	if(digits>FORMAT_HEX_DIGITS_MAX){
+		digits=FORMAT_HEX_DIGITS_MAX;
+	}
+	for(uint8_t i=digits;i>0;i--){
+		output[i-1]=format_hexDigits[value&0x0F];
+		value>>=4;
+	}
+	return digits;
+}
+
+uint16_t formatDecimal(char*output,uint32_t value,uint8_t width,char pad){
+	char digits[FORMAT_DECIMAL_DIGITS_MAX];
+	uint8_t count=0;
+	uint16_t length=0;
+
+	do{
+		digits[count++]=(char)('0'+value%10);
+		value/=10;
+	}while(value!=0);
+
+	if(width>count){
+		length=formatPad(output,pad,width-count);
+	}
+	while(count>0){
+		output[length++]=digits[--count];
+	}
+	return length;
+}
+
+uint16_t formatPad(char*output,char character,uint8_t count){
+	for(uint8_t i=0;i<count;i++){
+		output[i]=character;
+	}
+	return count;
+}
+
+uint16_t formatBar(char*output,uint8_t percent,uint8_t width){
+	uint16_t filled=((uint16_t)percent*(width+1))/100;
+
+	if(filled>width){
+		filled=width;
+	}
+	formatPad(output,'#',(uint8_t)filled);
+	formatPad(output+filled,'-',(uint8_t)(width-filled));
+
+	return width;
+}
+
+// Appends field of given length aligned in width, truncated at the end of buffer
+static uint16_t formatAppend(char*buffer,uint16_t length,uint16_t size,const char*field,uint16_t fieldLength,
+                             uint8_t width,uint8_t leftAlign,char pad){
+	uint16_t padding=(width>fieldLength)?(uint16_t)(width-fieldLength):0;
+
+	if(!leftAlign){
+		while(padding>0&&length<size){
+			buffer[length++]=pad;
+			padding--;
+		}
+	}
+	for(uint16_t i=0;i<fieldLength&&length<size;i++){
+		buffer[length++]=field[i];
+	}
+	while(padding>0&&length<size){
+		buffer[length++]=' ';
+		padding--;
+	}
+	return length;
+}
+
+uint16_t formatString(char*buffer,uint16_t size,const char*format,...){
+	char field[FORMAT_DECIMAL_DIGITS_MAX+1];
+	uint16_t length=0;
+	va_list arguments;
+
+	if(size==0){
+		return 0;
+	}
+	size--; // Space for NUL
+
+	va_start(arguments,format);
+	while(*format!='\0'&&length<size){
+		uint8_t leftAlign=0;
+		uint8_t width=0;
+		char pad=' ';
+		const char*text=field;
+		uint16_t fieldLength=0;
+
+		if(*format!='%'){
+			buffer[length++]=*format++;
+			continue;
+		}
+		format++;
+
+		// Flags, width and length modifier, int and long are both 32 bit on Cortex-M
+		for(;*format=='0'||*format=='-';format++){
+			if(*format=='0'){
+				pad='0';
+			}
+			else{
+				leftAlign=1;
+			}
+		}
+		while(*format>='0'&&*format<='9'){
+			width=(uint8_t)(width*10+(*format++-'0'));
+		}
+		while(*format=='l'){
+			format++;
+		}
+		if(leftAlign){
+			pad=' ';
+		}
+
+		switch(*format){
+			case 'u':
+				fieldLength=formatDecimal(field,va_arg(arguments,uint32_t),0,' ');
+				break;
+			case 'd':
+			case 'i':{
+				int32_t value=va_arg(arguments,int32_t);
+
+				if(value<0){
+					field[fieldLength++]='-';
+					// Sign goes before zero padding
+					if(pad=='0'&&length<size){
+						buffer[length++]='-';
+						fieldLength=0;
+						width=(width>0)?(uint8_t)(width-1):0;
+					}
+				}
+				fieldLength+=formatDecimal(&field[fieldLength],(value<0)?0u-(uint32_t)value:(uint32_t)value,0,' ');
+				break;
+			}
+			case 'X':
+			case 'x':{
+				uint32_t value=va_arg(arguments,uint32_t);
+				uint8_t digits=1;
+
+				while(digits<FORMAT_HEX_DIGITS_MAX&&(value>>(4*digits))!=0){
+					digits++;
+				}
+				fieldLength=formatHex(field,value,digits);
+				if(*format=='x'){
+					for(uint16_t i=0;i<fieldLength;i++){
+						if(field[i]>='A'){
+							field[i]=(char)(field[i]-'A'+'a');
+						}
+					}
+				}
+				break;
+			}
+			case 's':
+				text=va_arg(arguments,const char*);
+				while(text[fieldLength]!='\0'){
+					fieldLength++;
+				}
+				pad=' ';
+				break;
+			case 'c':
+				field[0]=(char)va_arg(arguments,int);
+				fieldLength=1;
+				break;
+			case '%':
+				field[0]='%';
+				fieldLength=1;
+				break;
+			case '\0':
+				format--; // Template ends with '%', stop on next iteration
+				break;
+			default:
+				field[0]='?';
+				fieldLength=1;
+				break;
+		}
+		format++;
+		length=formatAppend(buffer,length,size,text,fieldLength,width,leftAlign,pad);
+	}
+	va_end(arguments);
+
+	buffer[length]='\0';
+	return length;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file TrinityTrack6000_Format.h
+ * @brief Integer-only text formatting for TrinityTrack6000 project.
+ *
+ * Small replacement for `snprintf()` in diagnostics paths. Nothing is
+ * allocated, no floating point or locale code is linked and the stack
+ * usage is a few words, unlike newlib `vfprintf()`.
+ *
+ * Primitives write into a caller provided buffer and return the number of
+ * characters written, they do not append NUL:
+ * - `formatHex()` fixed number of uppercase hex digits
+ * - `formatDecimal()` unsigned decimal, right aligned with padding
+ * - `formatPad()` repeated character
+ * - `formatBar()` usage bar graph
+ *
+ * `formatString()` renders the printf subset used by the `msg_*_formatString*`
+ * templates: flags `0` and `-`, width, `l` modifier and conversions
+ * `u d X x s c %`. It is declared with the printf format attribute,
+ * so templates and arguments are checked by the compiler (-Wall -Werror).
+ * Unsupported conversions are rendered as `?`.
+ *
+ * @date 2025.09.14
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_FORMAT_H_
+    #define _TRINITYTRACK6000_FORMAT_H_
+
+#include <stdint.h>
+
+#define FORMAT_HEX_DIGITS_MAX     8
+#define FORMAT_DECIMAL_DIGITS_MAX 10
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Write value as uppercase hex with fixed number of digits.
+ * @param output Destination, at least digits characters
+ * @param value Value to write
+ * @param digits Number of digits (1..FORMAT_HEX_DIGITS_MAX), leading digits are zero
+ * @retval Number of characters written
+ */
+uint16_t formatHex(char*output,uint32_t value,uint8_t digits);
+
+/**
+ * @brief Write unsigned value as decimal, right aligned in width.
+ * @param output Destination, at least max(width,FORMAT_DECIMAL_DIGITS_MAX) characters
+ * @param value Value to write
+ * @param width Minimum number of characters
+ * @param pad Padding character, ' ' or '0'
+ * @retval Number of characters written
+ */
+uint16_t formatDecimal(char*output,uint32_t value,uint8_t width,char pad);
+
+/**
+ * @brief Write character repeated count times.
+ * @param output Destination, at least count characters
+ * @param character Character to repeat
+ * @param count Number of characters
+ * @retval Number of characters written
+ */
+uint16_t formatPad(char*output,char character,uint8_t count);
+
+/**
+ * @brief Write usage bar graph, e.g. `####------`.
+ *
+ * Number of filled cells is percent*(width+1)/100 limited to width,
+ * so a bar is full only above 90% for width 10.
+ *
+ * @param output Destination, at least width characters
+ * @param percent Usage in percent
+ * @param width Number of cells
+ * @retval Number of characters written
+ */
+uint16_t formatBar(char*output,uint8_t percent,uint8_t width);
+
+/**
+ * @brief Format text using printf subset.
+ *
+ * Output is truncated to size-1 characters and always NUL terminated.
+ *
+ * @param buffer Destination buffer
+ * @param size Size of destination buffer
+ * @param format printf style template
+ * @retval Number of characters written without NUL
+ */
+uint16_t formatString(char*buffer,uint16_t size,const char*format,...) __attribute__((format(printf,3,4)));
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_FORMAT_H_
@@ -0,0 +1,523 @@
+#include <stdint.h>
+
+#include <TrinityTrack6000_FpuBench.h>
+#include <TrinityTrack6000_Bench.h>
+#include <TrinityTrack6000_MemInfo.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Format.h>
+
+// Same code in Debug and Release, no-math-errno keeps sqrt a VSQRT without a libm fallback
+#define FPUBENCH_C_FUNC __attribute__((noinline,optimize("O2","no-math-errno")))
+#define FPUBENCH_ASM_FUNC __attribute__((naked,noinline))
+
+#define FPUBENCH_VARIANTS 3
+
+/* ---------------------------------------------------------------- dot */
+
+FPUBENCH_C_FUNC static float fpuBenchDotC(const float*a,const float*b,uint32_t n){
+	float sum=0.0f;
+
+	for(uint32_t i=0;i<n;i++){
+		sum+=a[i]*b[i];
+	}
+	return sum;
+}
+
+FPUBENCH_ASM_FUNC static float fpuBenchDotNaive(const float*a,const float*b,uint32_t n){
+	__asm volatile(
+		".syntax unified              \n"
+		"movs r3, #0                  \n"
+		"vmov s0, r3                  \n"
+		"1:                           \n"
+		"vldmia r0!, {s1}             \n"
+		"vldmia r1!, {s2}             \n"
+		"vfma.f32 s0, s1, s2          \n" // Waits for the previous VFMA
+		"subs r2, r2, #1              \n"
+		"bne 1b                       \n"
+		"bx lr                        \n"
+	);
+}
+
+FPUBENCH_ASM_FUNC static float fpuBenchDotScheduled(const float*a,const float*b,uint32_t n){
+	__asm volatile(
+		".syntax unified              \n"
+		"movs r3, #0                  \n"
+		"vmov s0, s1, r3, r3          \n"
+		"vmov s2, s3, r3, r3          \n"
+		"1:                           \n"
+		"vldmia r0!, {s4-s7}          \n"
+		"vldmia r1!, {s8-s11}         \n"
+		"vfma.f32 s0, s4, s8          \n" // Four independent chains
+		"vfma.f32 s1, s5, s9          \n"
+		"subs r2, r2, #4              \n"
+		"vfma.f32 s2, s6, s10         \n"
+		"vfma.f32 s3, s7, s11         \n"
+		"bne 1b                       \n"
+		"vadd.f32 s0, s0, s1          \n"
+		"vadd.f32 s2, s2, s3          \n"
+		"vadd.f32 s0, s0, s2          \n"
+		"bx lr                        \n"
+	);
+}
+
+/* ------------------------------------------------------------- biquad */
+
+FPUBENCH_C_FUNC static void fpuBenchBiquadC(FpuBenchBiquad*filter,const float*x,float*y,uint32_t n){
+	float s1=filter->s1;
+	float s2=filter->s2;
+
+	for(uint32_t i=0;i<n;i++){
+		float out=filter->b0*x[i]+s1;
+
+		s1=filter->b1*x[i]-filter->a1*out+s2;
+		s2=filter->b2*x[i]-filter->a2*out;
+		y[i]=out;
+	}
+	filter->s1=s1;
+	filter->s2=s2;
+}
+
+// s8-s12 coefficients, s13 s14 state
+FPUBENCH_ASM_FUNC static void fpuBenchBiquadNaive(FpuBenchBiquad*filter,const float*x,float*y,uint32_t n){
+	__asm volatile(
+		".syntax unified              \n"
+		"vldmia r0, {s8-s14}          \n"
+		"1:                           \n"
+		"vldmia r1!, {s0}             \n"
+		"vmul.f32 s1, s8, s0          \n"
+		"vadd.f32 s1, s1, s13         \n" // out=b0*x+s1
+		"vmul.f32 s2, s9, s0          \n"
+		"vfms.f32 s2, s11, s1         \n"
+		"vadd.f32 s13, s2, s14        \n" // s1=b1*x-a1*out+s2
+		"vmul.f32 s3, s10, s0         \n"
+		"vfms.f32 s3, s12, s1         \n"
+		"vmov.f32 s14, s3             \n" // s2=b2*x-a2*out
+		"vstmia r2!, {s1}             \n"
+		"subs r3, r3, #1              \n"
+		"bne 1b                       \n"
+		"vstr s13, [r0, #20]          \n"
+		"vstr s14, [r0, #24]          \n"
+		"bx lr                        \n"
+	);
+}
+
+FPUBENCH_ASM_FUNC static void fpuBenchBiquadScheduled(FpuBenchBiquad*filter,const float*x,float*y,uint32_t n){
+	__asm volatile(
+		".syntax unified              \n"
+		"vldmia r0, {s8-s14}          \n"
+		"1:                           \n"
+		"vldmia r1!, {s0}             \n"
+		"vfma.f32 s13, s8, s0         \n" // out, in place of s1
+		"vfma.f32 s14, s9, s0         \n" // s2+b1*x, does not need out
+		"vmul.f32 s15, s10, s0        \n" // b2*x, does not need out
+		"subs r3, r3, #1              \n"
+		"vfms.f32 s14, s11, s13       \n"
+		"vfms.f32 s15, s12, s13       \n"
+		"vstmia r2!, {s13}            \n"
+		"vmov.f32 s13, s14            \n"
+		"vmov.f32 s14, s15            \n"
+		"bne 1b                       \n"
+		"vstr s13, [r0, #20]          \n"
+		"vstr s14, [r0, #24]          \n"
+		"bx lr                        \n"
+	);
+}
+
+/* ---------------------------------------------------------------- pid */
+
+FPUBENCH_C_FUNC static void fpuBenchPidC(FpuBenchPidChannel*channel,uint32_t n,const FpuBenchPidGains*gains){
+	for(uint32_t i=0;i<n;i++,channel++){
+		float error=channel->setpoint-channel->measurement;
+		float dt=(float)channel->ticks*gains->tick;
+		float derivative=(error-channel->previous)/dt;
+		int32_t output;
+
+		channel->integral+=error*dt;
+		channel->previous=error;
+		output=(int32_t)(gains->kp*error+gains->ki*channel->integral+gains->kd*derivative);
+		if(output>INT16_MAX){
+			output=INT16_MAX;
+		}
+		else if(output<INT16_MIN){
+			output=INT16_MIN;
+		}
+		channel->output=output;
+	}
+}
+
+// s8-s11 gains, r0 channel
+FPUBENCH_ASM_FUNC static void fpuBenchPidNaive(FpuBenchPidChannel*channel,uint32_t n,const FpuBenchPidGains*gains){
+	__asm volatile(
+		".syntax unified              \n"
+		"vldmia r2, {s8-s11}          \n"
+		"1:                           \n"
+		"vldr s0, [r0, #0]            \n"
+		"vldr s1, [r0, #4]            \n"
+		"vsub.f32 s0, s0, s1          \n" // error
+		"vldr s2, [r0, #16]           \n"
+		"vcvt.f32.u32 s2, s2          \n"
+		"vmul.f32 s2, s2, s11         \n" // dt
+		"vldr s3, [r0, #12]           \n"
+		"vsub.f32 s3, s0, s3          \n"
+		"vdiv.f32 s3, s3, s2          \n" // derivative
+		"vldr s4, [r0, #8]            \n"
+		"vfma.f32 s4, s0, s2          \n"
+		"vstr s4, [r0, #8]            \n" // integral
+		"vstr s0, [r0, #12]           \n" // previous
+		"vmul.f32 s5, s0, s8          \n"
+		"vfma.f32 s5, s4, s9          \n"
+		"vfma.f32 s5, s3, s10         \n"
+		"vcvt.s32.f32 s5, s5          \n"
+		"vmov r3, s5                  \n"
+		"ssat r3, #16, r3             \n"
+		"str r3, [r0, #20]            \n" // output
+		"adds r0, r0, #24             \n"
+		"subs r1, r1, #1              \n"
+		"bne 1b                       \n"
+		"bx lr                        \n"
+	);
+}
+
+// r3 output of the previous channel, r12 that channel, the first store writes a placeholder to channel 0
+FPUBENCH_ASM_FUNC static void fpuBenchPidScheduled(FpuBenchPidChannel*channel,uint32_t n,const FpuBenchPidGains*gains){
+	__asm volatile(
+		".syntax unified              \n"
+		"vldmia r2, {s8-s11}          \n"
+		"movs r3, #0                  \n"
+		"mov r12, r0                  \n"
+		"1:                           \n"
+		"vldr s0, [r0, #0]            \n"
+		"vldr s1, [r0, #4]            \n"
+		"vldr s2, [r0, #16]           \n"
+		"vldr s3, [r0, #12]           \n"
+		"vsub.f32 s0, s0, s1          \n"
+		"vcvt.f32.u32 s2, s2          \n"
+		"vsub.f32 s3, s0, s3          \n"
+		"vmul.f32 s2, s2, s11         \n"
+		"vldr s4, [r0, #8]            \n"
+		"vdiv.f32 s3, s3, s2          \n"
+		"ssat r3, #16, r3             \n" // Under VDIV, previous channel output
+		"str r3, [r12, #20]           \n"
+		"mov r12, r0                  \n"
+		"adds r0, r0, #24             \n"
+		"subs r1, r1, #1              \n"
+		"vfma.f32 s4, s0, s2          \n"
+		"vmul.f32 s5, s0, s8          \n"
+		"vstr s0, [r12, #12]          \n"
+		"vfma.f32 s5, s4, s9          \n"
+		"vstr s4, [r12, #8]           \n"
+		"vfma.f32 s5, s3, s10         \n" // Waits for VDIV
+		"vcvt.s32.f32 s5, s5          \n"
+		"vmov r3, s5                  \n"
+		"bne 1b                       \n"
+		"ssat r3, #16, r3             \n"
+		"str r3, [r12, #20]           \n"
+		"bx lr                        \n"
+	);
+}
+
+/* -------------------------------------------------------------- scale */
+
+FPUBENCH_C_FUNC static void fpuBenchScaleC(const float*x,const float*power,int16_t*y,uint32_t n){
+	for(uint32_t i=0;i<n;i++){
+		int32_t value=(int32_t)(x[i]/__builtin_sqrtf(power[i])*32768.0f);
+
+		if(value>INT16_MAX){
+			value=INT16_MAX;
+		}
+		else if(value<INT16_MIN){
+			value=INT16_MIN;
+		}
+		y[i]=(int16_t)value;
+	}
+}
+
+FPUBENCH_ASM_FUNC static void fpuBenchScaleNaive(const float*x,const float*power,int16_t*y,uint32_t n){
+	__asm volatile(
+		".syntax unified              \n"
+		"1:                           \n"
+		"vldmia r1!, {s1}             \n"
+		"vsqrt.f32 s1, s1             \n"
+		"vldmia r0!, {s0}             \n"
+		"vdiv.f32 s0, s0, s1          \n"
+		"vcvt.s32.f32 s0, s0, #15     \n" // Q15, truncated like the C cast
+		"vmov r12, s0                 \n"
+		"ssat r12, #16, r12           \n"
+		"strh r12, [r2], #2           \n"
+		"subs r3, r3, #1              \n"
+		"bne 1b                       \n"
+		"bx lr                        \n"
+	);
+}
+
+// r4 r5 next element bits, r12 result of the previous element, element 0 is peeled
+FPUBENCH_ASM_FUNC static void fpuBenchScaleScheduled(const float*x,const float*power,int16_t*y,uint32_t n){
+	__asm volatile(
+		".syntax unified              \n"
+		"push {r4, r5}                \n"
+		"ldr r4, [r1], #4             \n"
+		"ldr r5, [r0], #4             \n"
+		"vmov s1, r4                  \n"
+		"vmov s0, r5                  \n"
+		"vsqrt.f32 s1, s1             \n"
+		"vdiv.f32 s0, s0, s1          \n"
+		"vcvt.s32.f32 s0, s0, #15     \n"
+		"vmov r12, s0                 \n"
+		"subs r3, r3, #1              \n"
+		"beq 2f                       \n"
+		"ldr r4, [r1], #4             \n"
+		"ldr r5, [r0], #4             \n"
+		"1:                           \n"
+		"vmov s1, r4                  \n"
+		"vmov s0, r5                  \n"
+		"vsqrt.f32 s1, s1             \n"
+		"ssat r12, #16, r12           \n" // Under VSQRT, previous element
+		"strh r12, [r2], #2           \n"
+		"subs r3, r3, #1              \n"
+		"vdiv.f32 s0, s0, s1          \n"
+		"itt ne                       \n" // Under VDIV, next element
+		"ldrne r4, [r1], #4           \n"
+		"ldrne r5, [r0], #4           \n"
+		"vcvt.s32.f32 s0, s0, #15     \n"
+		"vmov r12, s0                 \n"
+		"bne 1b                       \n"
+		"2:                           \n"
+		"ssat r12, #16, r12           \n"
+		"strh r12, [r2]               \n"
+		"pop {r4, r5}                 \n"
+		"bx lr                        \n"
+	);
+}
+
+/* ---------------------------------------------------------- benchmark */
+
+static float fpuBench_a[FPUBENCH_LENGTH];
+static float fpuBench_b[FPUBENCH_LENGTH];
+static float fpuBench_y[FPUBENCH_LENGTH];
+static float fpuBench_yReference[FPUBENCH_LENGTH];
+static int16_t fpuBench_q15[FPUBENCH_LENGTH];
+static int16_t fpuBench_q15Reference[FPUBENCH_LENGTH];
+static FpuBenchBiquad fpuBench_biquad;
+static FpuBenchBiquad fpuBench_biquadReference;
+static FpuBenchPidChannel fpuBench_pid[FPUBENCH_LENGTH];
+static FpuBenchPidChannel fpuBench_pidReference[FPUBENCH_LENGTH];
+static volatile float fpuBench_sink; // Keeps results alive
+
+static const FpuBenchBiquad fpuBench_biquadInitial={0.0675f,0.1349f,0.0675f,-1.1430f,0.4128f,0.0f,0.0f}; // Low pass, fc=fs/10
+static const FpuBenchPidGains fpuBench_gains={120.0f,40.0f,0.5f,0.001f};
+
+// Uniform in [-1, 1), the same sequence on every run
+static float fpuBenchRandom(uint32_t*seed){
+	*seed=*seed*1664525U+1013904223U;
+	return (float)((int32_t)(*seed>>8)-(1<<23))/8388608.0f;
+}
+
+static void fpuBenchReset(void){
+	uint32_t seed=0x7E57F00DU;
+
+	for(uint16_t i=0;i<FPUBENCH_LENGTH;i++){
+		fpuBench_a[i]=fpuBenchRandom(&seed);
+		fpuBench_b[i]=2.125f+1.875f*fpuBenchRandom(&seed); // Power for scale, 0.25 to 4
+		fpuBench_pid[i].setpoint=10.0f*fpuBenchRandom(&seed);
+		fpuBench_pid[i].measurement=10.0f*fpuBenchRandom(&seed);
+		fpuBench_pid[i].integral=0.0f;
+		fpuBench_pid[i].previous=0.0f;
+		fpuBench_pid[i].ticks=8+(seed>>29);
+		fpuBench_pid[i].output=0;
+	}
+	fpuBench_biquad=fpuBench_biquadInitial;
+}
+
+static uint8_t fpuBenchClose(float value,float reference){
+	float difference=(value>reference)?value-reference:reference-value;
+	float scale=(reference<0.0f)?-reference:reference;
+
+	return difference<=FPUBENCH_TOLERANCE*((scale>1.0f)?scale:1.0f);
+}
+
+static void fpuBenchRunDotC(void){
+	fpuBench_sink=fpuBenchDotC(fpuBench_a,fpuBench_b,FPUBENCH_LENGTH);
+}
+
+static void fpuBenchRunDotNaive(void){
+	fpuBench_sink=fpuBenchDotNaive(fpuBench_a,fpuBench_b,FPUBENCH_LENGTH);
+}
+
+static void fpuBenchRunDotScheduled(void){
+	fpuBench_sink=fpuBenchDotScheduled(fpuBench_a,fpuBench_b,FPUBENCH_LENGTH);
+}
+
+static void fpuBenchRunBiquadC(void){
+	fpuBenchBiquadC(&fpuBench_biquad,fpuBench_a,fpuBench_y,FPUBENCH_LENGTH);
+}
+
+static void fpuBenchRunBiquadNaive(void){
+	fpuBenchBiquadNaive(&fpuBench_biquad,fpuBench_a,fpuBench_y,FPUBENCH_LENGTH);
+}
+
+static void fpuBenchRunBiquadScheduled(void){
+	fpuBenchBiquadScheduled(&fpuBench_biquad,fpuBench_a,fpuBench_y,FPUBENCH_LENGTH);
+}
+
+static void fpuBenchRunPidC(void){
+	fpuBenchPidC(fpuBench_pid,FPUBENCH_LENGTH,&fpuBench_gains);
+}
+
+static void fpuBenchRunPidNaive(void){
+	fpuBenchPidNaive(fpuBench_pid,FPUBENCH_LENGTH,&fpuBench_gains);
+}
+
+static void fpuBenchRunPidScheduled(void){
+	fpuBenchPidScheduled(fpuBench_pid,FPUBENCH_LENGTH,&fpuBench_gains);
+}
+
+static void fpuBenchRunScaleC(void){
+	fpuBenchScaleC(fpuBench_a,fpuBench_b,fpuBench_q15,FPUBENCH_LENGTH);
+}
+
+static void fpuBenchRunScaleNaive(void){
+	fpuBenchScaleNaive(fpuBench_a,fpuBench_b,fpuBench_q15,FPUBENCH_LENGTH);
+}
+
+static void fpuBenchRunScaleScheduled(void){
+	fpuBenchScaleScheduled(fpuBench_a,fpuBench_b,fpuBench_q15,FPUBENCH_LENGTH);
+}
+
+// The C variant runs first and leaves the reference, run() is one asm variant from the same inputs
+static uint8_t fpuBenchCheckDot(void(*run)(void)){
+	float reference;
+
+	fpuBenchRunDotC();
+	reference=fpuBench_sink;
+	run();
+	return fpuBenchClose(fpuBench_sink,reference);
+}
+
+static uint8_t fpuBenchCheckBiquad(void(*run)(void)){
+	uint8_t ok;
+
+	fpuBenchReset();
+	fpuBenchRunBiquadC();
+	fpuBench_biquadReference=fpuBench_biquad;
+	for(uint16_t i=0;i<FPUBENCH_LENGTH;i++){
+		fpuBench_yReference[i]=fpuBench_y[i];
+	}
+	fpuBenchReset();
+	run();
+	ok=fpuBenchClose(fpuBench_biquad.s1,fpuBench_biquadReference.s1)&&fpuBenchClose(fpuBench_biquad.s2,fpuBench_biquadReference.s2);
+	for(uint16_t i=0;i<FPUBENCH_LENGTH;i++){
+		ok&=fpuBenchClose(fpuBench_y[i],fpuBench_yReference[i]);
+	}
+	return ok;
+}
+
+static uint8_t fpuBenchCheckPid(void(*run)(void)){
+	uint8_t ok=1;
+
+	fpuBenchReset();
+	fpuBenchRunPidC();
+	for(uint16_t i=0;i<FPUBENCH_LENGTH;i++){
+		fpuBench_pidReference[i]=fpuBench_pid[i];
+	}
+	fpuBenchReset();
+	run();
+	for(uint16_t i=0;i<FPUBENCH_LENGTH;i++){
+		const FpuBenchPidChannel*channel=&fpuBench_pid[i];
+		const FpuBenchPidChannel*reference=&fpuBench_pidReference[i];
+		int32_t difference=channel->output-reference->output;
+
+		ok&=fpuBenchClose(channel->integral,reference->integral)&&fpuBenchClose(channel->previous,reference->previous)&&
+			difference>=-1&&difference<=1;
+	}
+	return ok;
+}
+
+static uint8_t fpuBenchCheckScale(void(*run)(void)){
+	uint8_t ok=1;
+
+	fpuBenchRunScaleC();
+	for(uint16_t i=0;i<FPUBENCH_LENGTH;i++){
+		fpuBench_q15Reference[i]=fpuBench_q15[i];
+	}
+	run();
+	for(uint16_t i=0;i<FPUBENCH_LENGTH;i++){
+		int32_t difference=fpuBench_q15[i]-fpuBench_q15Reference[i];
+
+		ok&=difference>=-1&&difference<=1;
+	}
+	return ok;
+}
+
+typedef struct{
+	const char*name;
+	const char*benchName[FPUBENCH_VARIANTS];
+	void(*run[FPUBENCH_VARIANTS])(void); // C, naive, scheduled
+	uint8_t(*check)(void(*run)(void));
+}FpuBenchCase;
+
+static const FpuBenchCase fpuBench_cases[]={
+	{"dot",   {"fpu_dot_c",   "fpu_dot_naive",   "fpu_dot_sched"},
+		{fpuBenchRunDotC,fpuBenchRunDotNaive,fpuBenchRunDotScheduled},fpuBenchCheckDot},
+	{"biquad",{"fpu_biquad_c","fpu_biquad_naive","fpu_biquad_sched"},
+		{fpuBenchRunBiquadC,fpuBenchRunBiquadNaive,fpuBenchRunBiquadScheduled},fpuBenchCheckBiquad},
+	{"pid",   {"fpu_pid_c",   "fpu_pid_naive",   "fpu_pid_sched"},
+		{fpuBenchRunPidC,fpuBenchRunPidNaive,fpuBenchRunPidScheduled},fpuBenchCheckPid},
+	{"scale", {"fpu_scale_c", "fpu_scale_naive", "fpu_scale_sched"},
+		{fpuBenchRunScaleC,fpuBenchRunScaleNaive,fpuBenchRunScaleScheduled},fpuBenchCheckScale}
+};
+
+#define FPUBENCH_CASE_COUNT (sizeof(fpuBench_cases)/sizeof(fpuBench_cases[0]))
+
+MESSAGE_DEFINE(msg_fpuBench_header1,"+-------[ FPU/ALU KERNELS, cycles per element ]--------+\r\n");
+MESSAGE_DEFINE(msg_fpuBench_header2,"| Kernel   | C         | Naive asm | Sched asm | Check |\r\n");
+MESSAGE_DEFINE(msg_fpuBench_header3,"+----------+-----------+-----------+-----------+-------+\r\n");
+                                 //  | biquad   |     12.34 |     15.02 |      9.50 | ok    |
+static const char msg_fpuBench_formatStringCase[]="| %-8s | %6lu.%02lu | %6lu.%02lu | %6lu.%02lu | %-5s |\r\n";
+
+void fpuBenchRun(void){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	uint16_t length;
+	uint32_t median[FPUBENCH_CASE_COUNT][FPUBENCH_VARIANTS];
+	uint8_t ok[FPUBENCH_CASE_COUNT];
+
+	if(buffer==NULL){
+		return;
+	}
+	benchCalibrate();
+	for(uint8_t i=0;i<FPUBENCH_CASE_COUNT;i++){
+		const FpuBenchCase*test=&fpuBench_cases[i];
+
+		fpuBenchReset();
+		ok[i]=test->check(test->run[1])&&test->check(test->run[2]);
+		for(uint8_t variant=0;variant<FPUBENCH_VARIANTS;variant++){
+			BenchResult result;
+
+			fpuBenchReset();
+			benchMeasure(test->run[variant],&result);
+			benchPrint(test->benchName[variant],&result);
+			median[i][variant]=result.median;
+		}
+	}
+
+	uartTxWriteMessage(&msg_fpuBench_header1);
+	uartTxWriteMessage(&msg_fpuBench_header2);
+	uartTxWriteMessage(&msg_fpuBench_header3);
+	for(uint8_t i=0;i<FPUBENCH_CASE_COUNT;i++){
+		uint32_t hundredths[FPUBENCH_VARIANTS];
+
+		for(uint8_t variant=0;variant<FPUBENCH_VARIANTS;variant++){
+			hundredths[variant]=median[i][variant]*100/FPUBENCH_LENGTH;
+		}
+		length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_fpuBench_formatStringCase,
+			fpuBench_cases[i].name,                      // Kernel
+			hundredths[0]/100,hundredths[0]%100,         // Compiler
+			hundredths[1]/100,hundredths[1]%100,         // Naive asm
+			hundredths[2]/100,hundredths[2]%100,         // Hand scheduled asm
+			ok[i]?"ok":"FAIL"                            // Both asm variants match C
+		);
+		uartTxWrite((const uint8_t*)buffer,length);
+	}
+	uartTxWriteMessage(&msg_fpuBench_header3);
+	arenaRelease(&arena_scratch,mark);
+}
@@ -0,0 +1,95 @@
+/**
+ * @file TrinityTrack6000_FpuBench.h
+ * @brief FPU/ALU instruction interleaving benchmark for TrinityTrack6000 project.
+ *
+ * Four single precision kernels, each one in three variants:
+ * - `C`, compiled at -O2 whatever the build type (Debug is -O0)
+ * - naive asm, one element per iteration in statement order, every
+ *   instruction waits for the one before it
+ * - scheduled asm, the same arithmetic reordered by hand
+ *
+ * Kernels and what the scheduled variant changes:
+ * - dot, `sum a[i]*b[i]`: four accumulators and VLDM of four elements
+ *   instead of one VFMA chain
+ * - biquad, transposed direct form II: the terms which do not need the
+ *   output (`s2+b1*x`, `b2*x`) issue before the output is ready
+ * - pid, one update per channel with `dt` from a tick count: the saturation
+ *   and store of the previous channel output, the pointer and the loop
+ *   counter run while VDIV (14 cycles) computes the derivative
+ * - scale, `q15(x[i]/sqrt(p[i]))`: the saturation and store of the previous
+ *   element run under VSQRT, the loads of the next element under VDIV
+ *
+ * On the Cortex-M4 VDIV and VSQRT do not block the integer pipeline, only
+ * an instruction reading their result waits. Other floating point
+ * instructions may still wait for the divider, which is why the scheduled
+ * variants fill those 14 cycles with integer work.
+ *
+ * Asm variants are naked functions with AAPCS hard float arguments, every
+ * variant is checked against the C result before it is timed. Each variant
+ * is timed with `benchMeasure()` over `FPUBENCH_LENGTH` elements and prints
+ * a `BENCH fpu_<kernel>_<variant>` line, the table gives the median in
+ * cycles per element.
+ *
+ * @date 2025.09.26
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_FPUBENCH_H_
+    #define _TRINITYTRACK6000_FPUBENCH_H_
+
+#include <stdint.h>
+
+#define FPUBENCH_LENGTH    64    /**< Elements per call, multiple of 4 (dot) */
+#define FPUBENCH_TOLERANCE 1e-4f /**< Relative difference accepted against C */
+
+/**
+ * @brief Biquad coefficients and state, transposed direct form II
+ */
+typedef struct{
+    float b0;    /**< Feedforward coefficients */
+    float b1;
+    float b2;
+    float a1;    /**< Feedback coefficients, a0 is 1 */
+    float a2;
+    float s1;    /**< State */
+    float s2;
+}FpuBenchBiquad;
+
+/**
+ * @brief PID channel, offsets are used by the asm variants
+ */
+typedef struct{
+    float setpoint;    /**< 0 */
+    float measurement; /**< 4 */
+    float integral;    /**< 8, integral of the error */
+    float previous;    /**< 12, error of the previous update */
+    uint32_t ticks;    /**< 16, time since the previous update */
+    int32_t output;    /**< 20, saturated to int16 */
+}FpuBenchPidChannel;
+
+/**
+ * @brief PID gains shared by every channel
+ */
+typedef struct{
+    float kp;
+    float ki;
+    float kd;
+    float tick;  /**< Seconds per tick */
+}FpuBenchPidGains;
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Check and time every kernel variant and print the table.
+ *
+ * Meant for boot time, runs `BENCH_WARMUP+BENCH_ITERATIONS` calls of 12
+ * variants.
+ */
+void fpuBenchRun(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_FPUBENCH_H_
@@ -0,0 +1,214 @@
+#include <stdint.h>
+#include <stm32l4xx_hal.h>
+#include <core_cm4.h>
+
+#include <main.h>
+#include <TrinityTrack6000_Idle.h>
+#include <TrinityTrack6000_Clock.h>
+#include <TrinityTrack6000_MemHistory.h>
+#include <TrinityTrack6000_MemInfo.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Format.h>
+
+uint32_t idle_entries[IDLE_MODE_COUNT];
+uint32_t idle_ticks[IDLE_MODE_COUNT];
+uint32_t idle_wakeCyclesMax[IDLE_MODE_COUNT];
+uint32_t idle_lateTicksMax[IDLE_MODE_COUNT];
+uint32_t idle_overruns;
+uint64_t idle_driftTicks;
+uint64_t idle_driftNanos;
+
+static uint32_t idle_deadline;    // HAL_GetTick() of the end of the current cycle
+static uint32_t idle_fraction=0;  // LPTIM1 ticks not yet added to uwTick, below one ms
+static uint32_t idle_startTick;   // HAL_GetTick() at idleInit()
+static uint32_t idle_awakeCount;  // LPTIM1 count at the last wakeup
+static uint32_t idle_awakeCycles; // CYCCNT at the last wakeup
+
+MESSAGE_DEFINE(msg_idle_header1,"+-----------------------[ IDLE ]-----------------------+\r\n");
+MESSAGE_DEFINE(msg_idle_header2,"| Mode  | Entries | Idle [ms] | Wake [cyc] | Late [us] |\r\n");
+MESSAGE_DEFINE(msg_idle_header3,"+-------+---------+-----------+------------+-----------+\r\n");
+                            //  | sleep | 1234567 | 123456789 | 1234567890 | 123456789 |
+static const char msg_idle_formatStringMode[] ="| %-5s | %7lu | %9lu | %10lu | %9lu |\r\n";
+static const char msg_idle_formatStringIdle[] ="| Idle %3lu.%lu %% since boot, overruns %7lu            |\r\n";
+static const char msg_idle_formatStringDrift[]="| LSI against core clock %7ld ppm                   |\r\n";
+
+static const char*const idle_modeNames[IDLE_MODE_COUNT]={"sleep","stop2"};
+
+// LPTIM1 counts asynchronously to the bus, a read is valid when two in a row match
+static uint32_t idleCount(void){
+	uint32_t count;
+
+	do{
+		count=LPTIM1->CNT;
+	}while(count!=LPTIM1->CNT);
+	return count;
+}
+
+void idleInit(void){
+	// LSI feeds LPTIM1 in every mode down to Stop 2
+	RCC->CSR|=RCC_CSR_LSION;
+	while(!(RCC->CSR&RCC_CSR_LSIRDY)){
+	}
+	RCC->CCIPR=(RCC->CCIPR&~RCC_CCIPR_LPTIM1SEL)|RCC_CCIPR_LPTIM1SEL_0;
+	RCC->APB1ENR1|=RCC_APB1ENR1_LPTIM1EN;
+	(void)RCC->APB1ENR1;
+
+	// CFGR and IER are writable only while disabled, ARR and CMP only while enabled
+	LPTIM1->CR=0;
+	LPTIM1->CFGR=0; // Internal clock, no prescaler, software start
+	LPTIM1->IER=LPTIM_IER_CMPMIE;
+	LPTIM1->CR=LPTIM_CR_ENABLE;
+	LPTIM1->ARR=0xFFFF;
+	while(!(LPTIM1->ISR&LPTIM_ISR_ARROK)){
+	}
+	LPTIM1->ICR=LPTIM_ICR_ARROKCF;
+	LPTIM1->CMP=0xFFFF; // Leaves CMPOK set for the first sleep
+	while(!(LPTIM1->ISR&LPTIM_ISR_CMPOK)){
+	}
+	LPTIM1->CR|=LPTIM_CR_CNTSTRT;
+
+	// Direct EXTI line of LPTIM1, wakes the core from Stop 2
+	EXTI->IMR2|=EXTI_IMR2_IM32;
+	HAL_NVIC_SetPriority(LPTIM1_IRQn,0,0);
+	HAL_NVIC_EnableIRQ(LPTIM1_IRQn);
+
+	CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL|=DWT_CTRL_CYCCNTENA_Msk;
+
+	idle_startTick=HAL_GetTick();
+	idle_deadline=idle_startTick;
+	idle_awakeCycles=DWT->CYCCNT;
+	idle_awakeCount=idleCount();
+}
+
+void idleInterrupt(void){
+	LPTIM1->ICR=LPTIM_ICR_CMPMCF;
+}
+
+// Sleeps for up to ms, an earlier interrupt ends it, uwTick covers the time asleep
+static void idleSleep(uint32_t ms){
+	uint32_t mode=IDLE_MODE_SLEEP;
+	uint32_t start;
+	uint32_t compare;
+	uint32_t startCycles;
+	uint32_t wokeCycles;
+	uint32_t wakeCycles;
+	uint32_t end;
+	uint32_t elapsed;
+	uint32_t skipped;
+
+	if(ms>IDLE_WINDOW_MAX_MS){
+		ms=IDLE_WINDOW_MAX_MS;
+	}
+	if(IDLE_STOP2_ENABLED&&ms>=IDLE_STOP2_MIN_MS&&uartTxIsIdle()&&__HAL_UART_GET_FLAG(&uart,UART_FLAG_TC)){
+		mode=IDLE_MODE_STOP2;
+	}
+
+	// Masked interrupts still end WFI, they run once the tick is corrected
+	__disable_irq();
+	while(!(LPTIM1->ISR&LPTIM_ISR_CMPOK)){ // Previous compare write synchronized
+	}
+	LPTIM1->ICR=LPTIM_ICR_CMPOKCF|LPTIM_ICR_CMPMCF;
+	startCycles=DWT->CYCCNT;
+	start=idleCount();
+
+	// CYCCNT stops while the core sleeps, LSI is compared with the core clock over the time awake
+	idle_driftTicks+=(start-idle_awakeCount)&0xFFFF;
+	idle_driftNanos+=(uint64_t)(startCycles-idle_awakeCycles)*1000U/(SystemCoreClock/1000000U);
+	compare=(start+ms*IDLE_TICKS_PER_MS)&0xFFFF;
+	LPTIM1->CMP=compare;
+	HAL_SuspendTick();
+
+	if(mode==IDLE_MODE_STOP2){
+		HAL_PWREx_EnterSTOP2Mode(PWR_STOPENTRY_WFI);
+	}
+	else{
+		HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON,PWR_SLEEPENTRY_WFI);
+	}
+	wokeCycles=DWT->CYCCNT;
+	if(mode==IDLE_MODE_STOP2){
+		clockResume();
+	}
+
+	end=idleCount();
+	elapsed=(end-start)&0xFFFF;
+	idle_fraction+=elapsed;
+	skipped=idle_fraction/IDLE_TICKS_PER_MS;
+	idle_fraction%=IDLE_TICKS_PER_MS;
+	uwTick+=skipped;
+	memHistoryAdvance(skipped);
+	HAL_ResumeTick();
+	wakeCycles=DWT->CYCCNT-wokeCycles;
+
+	idle_entries[mode]++;
+	idle_ticks[mode]+=elapsed;
+	if(wakeCycles>idle_wakeCyclesMax[mode]){
+		idle_wakeCyclesMax[mode]=wakeCycles;
+	}
+	if(LPTIM1->ISR&LPTIM_ISR_CMPM){
+		uint32_t late=(elapsed-ms*IDLE_TICKS_PER_MS)&0xFFFF;
+
+		if(late<0x8000&&late>idle_lateTicksMax[mode]){
+			idle_lateTicksMax[mode]=late;
+		}
+	}
+	idle_awakeCycles=DWT->CYCCNT;
+	idle_awakeCount=idleCount();
+	__enable_irq();
+}
+
+void idleWaitPeriod(uint32_t periodMs){
+	int32_t remaining;
+
+	idle_deadline+=periodMs;
+	remaining=(int32_t)(idle_deadline-HAL_GetTick());
+	if(remaining<=0){
+		idle_overruns++;
+		idle_deadline=HAL_GetTick();
+		return;
+	}
+	while(remaining>0){
+		idleSleep((uint32_t)remaining);
+		remaining=(int32_t)(idle_deadline-HAL_GetTick());
+	}
+}
+
+void idleReport(void){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	uint16_t length;
+	uint32_t uptime=HAL_GetTick()-idle_startTick;
+	uint32_t permille=0;
+	int32_t ppm=0;
+
+	if(buffer==NULL){
+		return;
+	}
+	uartTxWriteMessage(&msg_idle_header1);
+	uartTxWriteMessage(&msg_idle_header2);
+	uartTxWriteMessage(&msg_idle_header3);
+	for(uint8_t mode=0;mode<IDLE_MODE_COUNT;mode++){
+		length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_idle_formatStringMode,
+			idle_modeNames[mode],                                             // Mode
+			idle_entries[mode],                                               // Sleeps
+			idle_ticks[mode]/IDLE_TICKS_PER_MS,                               // Time asleep
+			idle_wakeCyclesMax[mode],                                         // Longest wakeup
+			idle_lateTicksMax[mode]*IDLE_TICK_NS/1000U                        // Latest wakeup
+		);
+		uartTxWrite((const uint8_t*)buffer,length);
+	}
+	uartTxWriteMessage(&msg_idle_header3);
+	if(uptime!=0){
+		permille=(uint32_t)((uint64_t)(idle_ticks[IDLE_MODE_SLEEP]+idle_ticks[IDLE_MODE_STOP2])*1000U/IDLE_TICKS_PER_MS/uptime);
+	}
+	if(idle_driftNanos!=0){
+		// Positive when LSI runs fast, HAL_GetTick() then runs ahead while idle
+		ppm=(int32_t)(((int64_t)(idle_driftTicks*IDLE_TICK_NS)-(int64_t)idle_driftNanos)*1000000/(int64_t)idle_driftNanos);
+	}
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_idle_formatStringIdle,permille/10,permille%10,idle_overruns);
+	uartTxWrite((const uint8_t*)buffer,length);
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_idle_formatStringDrift,ppm);
+	uartTxWrite((const uint8_t*)buffer,length);
+	uartTxWriteMessage(&msg_idle_header3);
+	arenaRelease(&arena_scratch,mark);
+}
@@ -0,0 +1,97 @@
+/**
+ * @file TrinityTrack6000_Idle.h
+ * @brief Tickless idle on LPTIM1 for TrinityTrack6000 project.
+ *
+ * The main loop runs at a fixed period, `idleWaitPeriod()` replaces the
+ * busy `HAL_Delay()` between cycles. It computes the next deadline, programs
+ * the LPTIM1 compare for it, stops the SysTick interrupt and sleeps:
+ * - Sleep by default, DMA and every interrupt keep running
+ * - Stop 2 when `IDLE_STOP2_ENABLED`, the window is at least
+ *   `IDLE_STOP2_MIN_MS` and the UART transmitter is idle. USART2 is not
+ *   a Stop 2 wakeup source, input arriving in Stop 2 is lost, so it is meant
+ *   for unattended runs. The active clock profile is restored on wakeup
+ *   (`clockResume()`).
+ * Any interrupt ends the sleep early, the wait goes back to sleep until the
+ * deadline.
+ *
+ * LPTIM1 runs free from LSI (32 kHz, 32 ticks per ms), registers are
+ * written directly. It is not reset by sleeping, so the ticks between
+ * entry and wakeup are the idle time: `uwTick` is advanced by it with the
+ * fraction of a millisecond carried to the next sleep, `HAL_GetTick()` stays
+ * monotonic and does not drift against LPTIM. Skipped milliseconds are passed
+ * to the memory history so its samples keep their period.
+ *
+ * Measured per mode: entries, idle time, wakeup latency (cycles from the
+ * WFI return to the corrected tick, includes the clock restore after Stop 2)
+ * and lateness (LPTIM ticks between the compare match and the wakeup).
+ * The timing error of the idle tick itself is LSI against the core clock in
+ * ppm. CYCCNT stops while the core sleeps, so both are accumulated over the
+ * time awake between sleeps, the quantization of the short windows averages
+ * out. `idleReport()` prints them with command `c`.
+ *
+ * @date 2025.09.24
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_IDLE_H_
+    #define _TRINITYTRACK6000_IDLE_H_
+
+#include <stdint.h>
+
+#include <TrinityTrack6000_Config.h>
+#include <TrinityTrack6000_Placement.h>
+
+#define IDLE_LPTIM_HZ      32000                         /**< LSI, LPTIM1 clock */
+#define IDLE_TICKS_PER_MS  (IDLE_LPTIM_HZ/1000)          /**< LPTIM1 ticks per ms */
+#define IDLE_TICK_NS       (1000000000U/IDLE_LPTIM_HZ)   /**< LPTIM1 tick in ns */
+#define IDLE_WINDOW_MAX_MS (0xFFFF/IDLE_TICKS_PER_MS-1)  /**< Longest sleep, LPTIM1 counter is 16 bit */
+
+#define IDLE_MODE_SLEEP 0 /**< Sleep, core clock stopped */
+#define IDLE_MODE_STOP2 1 /**< Stop 2, every high speed clock stopped */
+#define IDLE_MODE_COUNT 2
+
+/**
+ * @brief Idle statistics, kept in RAM2
+ * @{
+ */
+extern uint32_t idle_entries[IDLE_MODE_COUNT]       RAM2_DIAG(idle_entries);       /**< Sleeps per mode */
+extern uint32_t idle_ticks[IDLE_MODE_COUNT]         RAM2_DIAG(idle_ticks);         /**< LPTIM1 ticks asleep per mode */
+extern uint32_t idle_wakeCyclesMax[IDLE_MODE_COUNT] RAM2_DIAG(idle_wakeCyclesMax); /**< WFI return to corrected tick */
+extern uint32_t idle_lateTicksMax[IDLE_MODE_COUNT]  RAM2_DIAG(idle_lateTicksMax);  /**< Compare match to wakeup */
+extern uint32_t idle_overruns                       RAM2_DIAG(idle_overruns);      /**< Cycles which missed their deadline */
+extern uint64_t idle_driftTicks                     RAM2_DIAG(idle_driftTicks);    /**< LPTIM1 ticks awake */
+extern uint64_t idle_driftNanos                     RAM2_DIAG(idle_driftNanos);    /**< Core clock time awake in ns */
+/** @} */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Start LSI and LPTIM1, boot stage.
+ */
+void idleInit(void);
+
+/**
+ * @brief Sleep until the next cycle of a fixed period loop.
+ *
+ * A cycle which ends after its deadline is counted in `idle_overruns` and
+ * restarts the period from now instead of running cycles back to back.
+ * @param periodMs Loop period in ms, at most `IDLE_WINDOW_MAX_MS`
+ */
+void idleWaitPeriod(uint32_t periodMs);
+
+/**
+ * @brief LPTIM1 interrupt, clears the compare match.
+ */
+void idleInterrupt(void);
+
+/**
+ * @brief Print the idle statistics.
+ */
+void idleReport(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_IDLE_H_
@@ -0,0 +1,211 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stm32l4xx_hal.h>
+#include <core_cm4.h>
+
+#include <TrinityTrack6000_Log.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Telemetry.h>
+#include <TrinityTrack6000_Placement.h>
+
+// Multi-producer ring, indexes are free running and masked on access
+typedef struct{
+	char*buffer;
+	uint32_t mask;
+	volatile uint32_t reserveHead; // Space claimed by writers
+	volatile uint32_t commitHead;  // Data visible to consumer
+	volatile uint32_t tail;        // Written only by logDrain()
+	volatile uint32_t writers;     // Writers in progress (nesting depth)
+}LogRing;
+
+static char log_buffer[LOG_BUFFER_SIZE] RAM2_LOG(log_buffer);
+static char log_tokenBuffer[LOG_TOKEN_BUFFER_SIZE] RAM2_LOG(log_tokenBuffer);
+
+static LogRing log_textRing  RAM2_LOG(log_textRing);
+static LogRing log_tokenRing RAM2_LOG(log_tokenRing);
+
+uint32_t log_droppedBytes=0;
+uint32_t log_writeCyclesLast=0;
+uint32_t log_writeCyclesMax=0;
+
+uint32_t log_droppedTokens=0;
+uint32_t log_tokenCyclesLast=0;
+uint32_t log_tokenCyclesMax=0;
+
+static uint32_t logAtomicAdd(volatile uint32_t*value,int32_t delta){
+	uint32_t result;
+
+	do{
+		result=__LDREXW(value)+(uint32_t)delta;
+	}while(__STREXW(result,value));
+
+	return result;
+}
+
+// Writer leaving, the outermost one publishes everything reserved so far
+static void logCommit(LogRing*ring){
+	if(logAtomicAdd(&ring->writers,-1)!=0){
+		return;
+	}
+	// Copied data must be visible before commit index
+	__DMB();
+	// Exception entry clears exclusive monitor, a preempting writer forces a retry
+	do{
+		(void)__LDREXW(&ring->commitHead);
+	}while(__STREXW(ring->reserveHead,&ring->commitHead));
+}
+
+static void logRingInit(LogRing*ring,char*buffer,uint32_t size){
+	ring->buffer=buffer;
+	ring->mask=size-1;
+	ring->reserveHead=0;
+	ring->commitHead=0;
+	ring->tail=0;
+	ring->writers=0;
+}
+
+// Appends data as a whole or not at all, returns 0 when the ring is full
+static uint32_t logRingWrite(LogRing*ring,const void*data,uint32_t length){
+	uint32_t head;
+	uint32_t offset;
+	uint32_t firstPart;
+
+	logAtomicAdd(&ring->writers,1);
+
+	do{
+		head=__LDREXW(&ring->reserveHead);
+		if(head+length-ring->tail>ring->mask+1){
+			__CLREX();
+			logCommit(ring);
+			return 0;
+		}
+	}while(__STREXW(head+length,&ring->reserveHead));
+
+	offset=head&ring->mask;
+	firstPart=ring->mask+1-offset;
+	if(firstPart>length){
+		firstPart=length;
+	}
+	memcpy(&ring->buffer[offset],data,firstPart);
+	memcpy(ring->buffer,(const char*)data+firstPart,length-firstPart);
+
+	logCommit(ring);
+	return length;
+}
+
+// Consumer must finish reading before writers can reuse the space
+static void logRingRelease(LogRing*ring,uint32_t tail){
+	__DMB();
+	ring->tail=tail;
+}
+
+void logInit(void){
+	logRingInit(&log_textRing,log_buffer,LOG_BUFFER_SIZE);
+	logRingInit(&log_tokenRing,log_tokenBuffer,LOG_TOKEN_BUFFER_SIZE);
+
+	log_droppedBytes=0;
+	log_writeCyclesLast=0;
+	log_writeCyclesMax=0;
+
+	log_droppedTokens=0;
+	log_tokenCyclesLast=0;
+	log_tokenCyclesMax=0;
+
+#if NEWLIB_HEAP_ENABLED
+	// stdio allocates its buffers from newlib heap, which is only linked with NEWLIB_HEAP
+	setvbuf(stdout,NULL,_IONBF,0);
+#endif
+}
+
+uint32_t logWrite(const char*data,uint32_t length){
+	uint32_t start=DWT->CYCCNT;
+
+	if(logRingWrite(&log_textRing,data,length)==0){
+		logAtomicAdd(&log_droppedBytes,(int32_t)length); // Writers may preempt each other
+		return 0;
+	}
+
+	log_writeCyclesLast=DWT->CYCCNT-start;
+	if(log_writeCyclesLast>log_writeCyclesMax){
+		log_writeCyclesMax=log_writeCyclesLast;
+	}
+	return length;
+}
+
+void logToken(uint16_t token,const uint32_t*arguments,uint8_t count){
+	uint32_t start=DWT->CYCCNT;
+	uint8_t entry[LOG_TOKEN_ENTRY_SIZE];
+	uint8_t length=(uint8_t)(sizeof(token)+count*sizeof(uint32_t));
+
+	// Entry is length byte followed by the log frame records
+	entry[0]=length;
+	entry[1]=(uint8_t)token;
+	entry[2]=(uint8_t)(token>>8);
+	memcpy(&entry[3],arguments,count*sizeof(uint32_t));
+
+	if(logRingWrite(&log_tokenRing,entry,1u+length)==0){
+		logAtomicAdd(&log_droppedTokens,1);
+		return;
+	}
+
+	log_tokenCyclesLast=DWT->CYCCNT-start;
+	if(log_tokenCyclesLast>log_tokenCyclesMax){
+		log_tokenCyclesMax=log_tokenCyclesLast;
+	}
+}
+
+static void logDrainText(void){
+	uint32_t tail=log_textRing.tail;
+	uint32_t commit=log_textRing.commitHead;
+
+	while(tail!=commit){
+		uint32_t offset=tail&log_textRing.mask;
+		uint32_t chunk=log_textRing.mask+1-offset;
+		uint32_t space=UART_TX_BUFFER_SIZE-uartTxPending();
+
+		if(chunk>commit-tail){
+			chunk=commit-tail;
+		}
+		if(chunk>space){
+			chunk=space;
+		}
+		if(chunk==0||uartTxWrite((const uint8_t*)&log_textRing.buffer[offset],(uint16_t)chunk)!=HAL_OK){
+			break; // Transmitter full, rest is sent on next drain
+		}
+		tail+=chunk;
+	}
+	logRingRelease(&log_textRing,tail);
+}
+
+static void logDrainTokens(void){
+	uint32_t tail=log_tokenRing.tail;
+	uint32_t commit=log_tokenRing.commitHead;
+	uint8_t records[LOG_TOKEN_ENTRY_SIZE];
+
+	while(tail!=commit){
+		uint8_t length=(uint8_t)log_tokenRing.buffer[tail&log_tokenRing.mask];
+
+		if(UART_TX_BUFFER_SIZE-uartTxPending()<TELEMETRY_FRAME_SIZE_MAX(length)){
+			break; // Transmitter full, entry is framed on next drain
+		}
+		for(uint8_t i=0;i<length;i++){
+			records[i]=(uint8_t)log_tokenRing.buffer[(tail+1+i)&log_tokenRing.mask];
+		}
+		telemetrySendFrame(TELEMETRY_FRAME_LOG,records,length);
+		tail+=1u+length;
+	}
+	logRingRelease(&log_tokenRing,tail);
+}
+
+void logDrain(void){
+	logDrainTokens();
+	logDrainText();
+}
+
+int __io_putchar(int ch){
+	char c=(char)ch;
+
+	logWrite(&c,1);
+	return ch;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file TrinityTrack6000_Log.h
+ * @brief Lock-free printf backend for TrinityTrack6000 project.
+ *
+ * newlib `_write()` appends into a ring buffer placed in RAM2 (`.logBuffer`
+ * section) instead of sending characters one at a time. Writers claim space
+ * with LDREX/STREX, so `printf()` may be called from thread context and
+ * from any interrupt, including interrupts preempting another writer.
+ * Data becomes visible to the consumer when the outermost writer finishes.
+ *
+ * The single consumer, `logDrain()`, moves committed data into the DMA
+ * UART transmitter from the main loop, so a log call costs a memory copy
+ * (measured in `log_writeCycles*`) instead of UART wire time.
+ *
+ * Tokenized logging:
+ * `LOG_TOKEN("| %02u Clock Initialized\r\n",step)` places the format string
+ * in `.logStrings`, a section kept in the ELF file but not loaded to flash.
+ * The address of the string inside this section is its token, so the
+ * firmware sends only the 16 bit token and up to `LOG_TOKEN_ARGS_MAX`
+ * 32 bit integer arguments as a telemetry frame (`TELEMETRY_FRAME_LOG`).
+ * `Scripts/log_decode.py` looks the tokens up in the ELF file and formats
+ * the text on the host. Arguments are checked against the format at compile
+ * time, only integer conversions are supported (no `%s`, no floats).
+ * With `LOG_TOKENIZED` set to 0 the same calls are formatted on target
+ * by `formatString()` and appended to the text ring.
+ *
+ * @date 2025.09.12
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_LOG_H_
+    #define _TRINITYTRACK6000_LOG_H_
+
+#include <stdint.h>
+
+#include <TrinityTrack6000_Config.h>
+#include <TrinityTrack6000_Format.h>
+
+#define LOG_BUFFER_MASK (LOG_BUFFER_SIZE-1)
+
+#if (LOG_BUFFER_SIZE&LOG_BUFFER_MASK)!=0
+    #error "LOG_BUFFER_SIZE must be a power of 2"
+#endif
+
+#if (LOG_TOKEN_BUFFER_SIZE&(LOG_TOKEN_BUFFER_SIZE-1))!=0
+    #error "LOG_TOKEN_BUFFER_SIZE must be a power of 2"
+#endif
+
+#define LOG_TOKEN_ARGS_MAX   4
+#define LOG_TOKEN_ENTRY_SIZE (1+2+4*LOG_TOKEN_ARGS_MAX)
+
+#if LOG_TOKENIZED
+/**
+ * @brief Log message as token and packed integer arguments.
+ * @param format printf style format string literal
+ */
+    #define LOG_TOKEN(format,...) do{ \
+        static const char log_tokenString[] __attribute__((section(".logStrings"),used))=format; \
+        const uint32_t log_tokenArguments[]={0,##__VA_ARGS__}; \
+        _Static_assert(sizeof(log_tokenArguments)/sizeof(uint32_t)-1<=LOG_TOKEN_ARGS_MAX,"Too many LOG_TOKEN arguments"); \
+        (void)sizeof(formatString(NULL,0,format,##__VA_ARGS__)); \
+        logToken((uint16_t)(uint32_t)log_tokenString,&log_tokenArguments[1], \
+                 (uint8_t)(sizeof(log_tokenArguments)/sizeof(uint32_t)-1)); \
+    }while(0)
+#else
+    #define LOG_TOKEN(format,...) do{ \
+        char log_tokenLine[LOG_TOKEN_LINE_SIZE]; \
+        logWrite(log_tokenLine,formatString(log_tokenLine,sizeof(log_tokenLine),format,##__VA_ARGS__)); \
+    }while(0)
+#endif
+
+/**
+ * @brief Log ring statistics
+ * @{
+ */
+extern uint32_t log_droppedBytes;    /**< Bytes rejected because the ring was full */
+extern uint32_t log_writeCyclesLast; /**< Duration of the last write in CPU cycles */
+extern uint32_t log_writeCyclesMax;  /**< Longest write in CPU cycles */
+extern uint32_t log_droppedTokens;   /**< Tokenized messages rejected because the ring was full */
+extern uint32_t log_tokenCyclesLast; /**< Duration of the last tokenized log call in CPU cycles */
+extern uint32_t log_tokenCyclesMax;  /**< Longest tokenized log call in CPU cycles */
+/** @} */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Initialize log ring.
+ *
+ * The rings live in `.logBuffer`, which startup leaves uninitialized
+ * (only `.sysDiag` is copied and `.ramDiagnostics` zeroed in RAM2), so
+ * indexes are reset here.
+ * With `NEWLIB_HEAP_ENABLED` also disables stdout buffering, so newlib
+ * does not allocate a buffer and every `printf()` reaches `_write()`
+ * directly. Without the heap stdio buffering cannot be linked at all (see
+ * TrinityTrack6000_Pool.h).
+ */
+void logInit(void);
+
+/**
+ * @brief Append data to log ring.
+ *
+ * Safe to call from thread context and interrupts. Data is appended
+ * as a whole or not at all.
+ *
+ * @param data Pointer to data
+ * @param length Number of bytes
+ * @retval Number of bytes appended (0 or length)
+ */
+uint32_t logWrite(const char*data,uint32_t length);
+
+/**
+ * @brief Append tokenized message to token ring, use `LOG_TOKEN()` instead.
+ *
+ * Safe to call from thread context and interrupts.
+ *
+ * @param token Offset of the format string in `.logStrings`
+ * @param arguments Integer arguments
+ * @param count Number of arguments (up to LOG_TOKEN_ARGS_MAX)
+ */
+void logToken(uint16_t token,const uint32_t*arguments,uint8_t count);
+
+/**
+ * @brief Move committed log data into the UART transmitter.
+ *
+ * Tokenized messages are framed as telemetry frames, text is sent as is.
+ * Single consumer, must be called from thread context only (main loop).
+ */
+void logDrain(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_LOG_H_
@@ -0,0 +1,261 @@
+#include <stdint.h>
+#include <string.h>
+#include <stm32l4xx_hal.h>
+#include <core_cm4.h>
+
+#include <TrinityTrack6000_MemHistory.h>
+#include <TrinityTrack6000_Placement.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Format.h>
+#include <TrinityTrack6000_Arena.h>
+
+#define MEMHISTORY_TIME_CELL_WIDTH 13 // "| 4294967295 "
+#define MEMHISTORY_CELL_WIDTH      12 // "| 4294967295" without the leading border
+
+_Static_assert(MEMHISTORY_TIME_CELL_WIDTH+MEMHISTORY_CHANNEL_COUNT*MEMHISTORY_CELL_WIDTH+1+2<=MEMINFO_LINE_BUFFER_SIZE,
+               "History row does not fit into MEMINFO_LINE_BUFFER_SIZE, too many banks");
+
+MemSample memHistory_ring[MEMHISTORY_DEPTH];
+uint32_t memHistory_min[MEMHISTORY_CHANNEL_COUNT];
+uint32_t memHistory_max[MEMHISTORY_CHANNEL_COUNT];
+uint32_t memHistory_sum[MEMHISTORY_CHANNEL_COUNT];
+uint32_t memHistory_samples;
+uint32_t memHistory_missed;
+uint32_t memHistory_cyclesLast;
+uint32_t memHistory_cyclesMax;
+uint32_t memHistory_overBudget;
+
+static uint32_t memHistory_head RAM2_DIAG(memHistory_head);
+static uint32_t memHistory_bankStatic[MEMINFO_BANK_COUNT] RAM2_DIAG(memHistory_bankStatic);
+
+// Kept in .bss, SysTick runs before memHistoryInit() has taken the static size of every bank
+static volatile uint8_t memHistory_enabled=0;
+static volatile uint8_t memHistory_frozen=0;
+static uint16_t memHistory_divider=0;
+
+void memHistoryInit(void){
+	const MemRegion*region=ramDiagnostics_regions;
+
+	memHistory_enabled=0;
+
+	memset(memHistory_ring,0,sizeof(memHistory_ring));
+	memset(memHistory_min,0xFF,sizeof(memHistory_min));
+	memset(memHistory_max,0,sizeof(memHistory_max));
+	memset(memHistory_sum,0,sizeof(memHistory_sum));
+	memset(memHistory_bankStatic,0,sizeof(memHistory_bankStatic));
+	memHistory_head=0;
+	memHistory_samples=0;
+	memHistory_missed=0;
+	memHistory_cyclesLast=0;
+	memHistory_cyclesMax=0;
+	memHistory_overBudget=0;
+
+	// Regions with usedEnd (pools, heap, stack) are sampled
+	for(uint8_t i=0;i<MEMINFO_REGION_COUNT;i++,region++){
+		if(region->usedEnd==NULL){
+			memHistory_bankStatic[region->bank]+=(uint32_t)region->end-(uint32_t)region->start;
+		}
+	}
+
+	// Sample cost is measured with the cycle counter
+	CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL|=DWT_CTRL_CYCCNTENA_Msk;
+
+	memHistory_frozen=0;
+	memHistory_divider=0;
+	memHistory_enabled=1;
+}
+
+void memHistoryTick(void){
+	if(++memHistory_divider<MEMHISTORY_PERIOD_MS){
+		return;
+	}
+	memHistory_divider=0;
+	memHistorySample();
+}
+
+void memHistoryAdvance(uint32_t ms){
+	uint32_t divider=memHistory_divider+ms;
+
+	memHistory_divider=(uint16_t)((divider>=MEMHISTORY_PERIOD_MS)?MEMHISTORY_PERIOD_MS-1:divider);
+}
+
+void memHistorySample(void){
+	uint32_t start=DWT->CYCCNT;
+	MemSample*sample=&memHistory_ring[memHistory_head];
+	const MemRegion*region=ramDiagnostics_regions;
+
+	if(!memHistory_enabled){
+		return;
+	}
+	if(memHistory_frozen){
+		memHistory_missed++;
+		return;
+	}
+	// Oldest sample is overwritten and leaves the window sum
+	if(memHistory_samples>=MEMHISTORY_DEPTH){
+		for(uint8_t channel=0;channel<MEMHISTORY_CHANNEL_COUNT;channel++){
+			memHistory_sum[channel]-=sample->value[channel];
+		}
+	}
+
+	sample->tick=HAL_GetTick();
+	for(uint8_t bank=0;bank<MEMINFO_BANK_COUNT;bank++){
+		sample->value[MEMHISTORY_CHANNEL_BANK+bank]=memHistory_bankStatic[bank];
+	}
+	for(uint8_t i=0;i<MEMINFO_REGION_COUNT;i++,region++){
+		uint32_t used;
+
+		if(region->usedEnd==NULL){
+			continue;
+		}
+		// Stack is sampled from MSP, its usedEnd() scans the painted stack
+		if(region->flags&MEMINFO_REGION_GROWS_DOWN){
+			used=(uint32_t)region->end-__get_MSP();
+		}
+		else{
+			used=region->usedEnd()-(uint32_t)region->start;
+		}
+		sample->value[MEMHISTORY_CHANNEL_BANK+region->bank]+=used;
+		if(i==MEMINFO_REGION_HEAP){
+			sample->value[MEMHISTORY_CHANNEL_HEAP]=used;
+		}
+		else if(i==MEMINFO_REGION_STACK){
+			sample->value[MEMHISTORY_CHANNEL_STACK]=used;
+		}
+	}
+
+	for(uint8_t channel=0;channel<MEMHISTORY_CHANNEL_COUNT;channel++){
+		uint32_t value=sample->value[channel];
+
+		memHistory_sum[channel]+=value;
+		if(value<memHistory_min[channel]){
+			memHistory_min[channel]=value;
+		}
+		if(value>memHistory_max[channel]){
+			memHistory_max[channel]=value;
+		}
+	}
+	if(++memHistory_head>=MEMHISTORY_DEPTH){
+		memHistory_head=0;
+	}
+	memHistory_samples++;
+
+	memHistory_cyclesLast=DWT->CYCCNT-start;
+	if(memHistory_cyclesLast>memHistory_cyclesMax){
+		memHistory_cyclesMax=memHistory_cyclesLast;
+	}
+	if(memHistory_cyclesLast>MEMHISTORY_SAMPLE_CYCLES_MAX){
+		memHistory_overBudget++;
+	}
+}
+
+// Sends "+------------+-----------+...+" border, title is centered when given
+static void memHistorySendBorder(const char*title){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	uint16_t width=MEMHISTORY_TIME_CELL_WIDTH+MEMHISTORY_CHANNEL_COUNT*MEMHISTORY_CELL_WIDTH+1;
+	uint16_t length=0;
+
+	if(buffer==NULL){
+		return;
+	}
+	buffer[length++]='+';
+	if(title!=NULL){
+		uint16_t titleLength=(uint16_t)strlen(title);
+
+		length+=formatPad(&buffer[length],'-',(uint8_t)((width-2-titleLength)/2));
+		memcpy(&buffer[length],title,titleLength);
+		length+=titleLength;
+		length+=formatPad(&buffer[length],'-',(uint8_t)(width-1-length));
+	}
+	else{
+		length+=formatPad(&buffer[length],'-',MEMHISTORY_TIME_CELL_WIDTH-1);
+		for(uint8_t channel=0;channel<MEMHISTORY_CHANNEL_COUNT;channel++){
+			buffer[length++]='+';
+			length+=formatPad(&buffer[length],'-',MEMHISTORY_CELL_WIDTH-1);
+		}
+	}
+	buffer[length++]='+';
+	buffer[length++]='\r';
+	buffer[length++]='\n';
+
+	uartTxWrite((const uint8_t*)buffer,length);
+	arenaRelease(&arena_scratch,mark);
+}
+
+// Sends one row, label replaces the time column when given
+static void memHistorySendRow(const char*label,uint32_t tick,const uint32_t*value){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	uint16_t length;
+
+	if(buffer==NULL){
+		return;
+	}
+	if(label!=NULL){
+		length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,"| %-10s |",label);
+	}
+	else{
+		length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,"| %10lu |",tick);
+	}
+	for(uint8_t channel=0;channel<MEMHISTORY_CHANNEL_COUNT;channel++){
+		length+=formatString(&buffer[length],MEMINFO_LINE_BUFFER_SIZE-length," %9lu |",value[channel]);
+	}
+	length+=formatString(&buffer[length],MEMINFO_LINE_BUFFER_SIZE-length,"\r\n");
+
+	uartTxWrite((const uint8_t*)buffer,length);
+	arenaRelease(&arena_scratch,mark);
+}
+
+void memHistoryDump(void){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	uint32_t average[MEMHISTORY_CHANNEL_COUNT];
+	uint32_t count;
+	uint32_t index;
+	uint16_t length;
+
+	if(buffer==NULL){
+		return;
+	}
+	memHistory_frozen=1;
+
+	count=(memHistory_samples<MEMHISTORY_DEPTH)?memHistory_samples:MEMHISTORY_DEPTH;
+	index=(memHistory_head+MEMHISTORY_DEPTH-count)%MEMHISTORY_DEPTH;
+// Send headers
+	memHistorySendBorder("[ MEMORY HISTORY [B] ]");
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,"| %-10s | %-9s | %-9s |","Time [ms]","Heap","Stack");
+	for(uint8_t bank=0;bank<MEMINFO_BANK_COUNT;bank++){
+		length+=formatString(&buffer[length],MEMINFO_LINE_BUFFER_SIZE-length," %-9s |",ramDiagnostics_banks[bank].name);
+	}
+	length+=formatString(&buffer[length],MEMINFO_LINE_BUFFER_SIZE-length,"\r\n");
+	uartTxWrite((const uint8_t*)buffer,length);
+	memHistorySendBorder(NULL);
+// Send samples, oldest first
+	for(uint32_t i=0;i<count;i++){
+		memHistorySendRow(NULL,memHistory_ring[index].tick,memHistory_ring[index].value);
+		if(++index>=MEMHISTORY_DEPTH){
+			index=0;
+		}
+	}
+	memHistorySendBorder(NULL);
+// Send statistics
+	for(uint8_t channel=0;channel<MEMHISTORY_CHANNEL_COUNT;channel++){
+		average[channel]=count?memHistory_sum[channel]/count:0;
+	}
+	memHistorySendRow("MIN",0,count?memHistory_min:average);
+	memHistorySendRow("MAX",0,memHistory_max);
+	memHistorySendRow("AVG",0,average);
+	memHistorySendBorder(NULL);
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,"| Samples %lu, missed %lu, period %u ms\r\n",
+		memHistory_samples,memHistory_missed,MEMHISTORY_PERIOD_MS);
+	uartTxWrite((const uint8_t*)buffer,length);
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,"| Sample cycles last %lu, max %lu, budget %u, over budget %lu\r\n",
+		memHistory_cyclesLast,memHistory_cyclesMax,MEMHISTORY_SAMPLE_CYCLES_MAX,memHistory_overBudget);
+	uartTxWrite((const uint8_t*)buffer,length);
+	memHistorySendBorder("");
+	arenaRelease(&arena_scratch,mark);
+
+	memHistory_frozen=0;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file TrinityTrack6000_MemHistory.h
+ * @brief Memory usage history for TrinityTrack6000 project.
+ *
+ * `ramDiagnosticsRefresh()` is a single snapshot, transient heap and stack
+ * spikes under load are easily missed by it. This module samples memory
+ * usage every `MEMHISTORY_PERIOD_MS` from the SysTick interrupt (lowest
+ * priority, `TICK_INT_PRIORITY`) into a ring of `MEMHISTORY_DEPTH` samples
+ * in the `.ramDiagnostics` section.
+ *
+ * Every sample holds the uptime and one value per channel, all in bytes:
+ * - `MEMHISTORY_CHANNEL_HEAP` heap end minus heap start
+ * - `MEMHISTORY_CHANNEL_STACK` top of stack minus MSP (inside SysTick, so
+ *   the interrupted context is included)
+ * - `MEMHISTORY_CHANNEL_BANK+bank` used bytes of every `MEMINFO_BANKS` bank,
+ *   static regions are summed once by `memHistoryInit()`, regions with
+ *   `usedEnd` (pools, heap) are sampled, except the stack taken from MSP
+ *
+ * Byte values (instead of addresses) keep the window sums in 32 bits,
+ * so no 64 bit division is needed for the average.
+ * Minimum and maximum are kept since `memHistoryInit()`, the average is
+ * taken over the samples currently held in the ring.
+ *
+ * A sample is a fixed number of loads and stores, its cost is measured with
+ * DWT CYCCNT on every sample and compared to `MEMHISTORY_SAMPLE_CYCLES_MAX`.
+ * `memHistoryDump()` (command `h`) prints the ring as a time series followed
+ * by the statistics.
+ *
+ * @date 2025.09.15
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_MEMHISTORY_H_
+    #define _TRINITYTRACK6000_MEMHISTORY_H_
+
+#include <stdint.h>
+
+#include <TrinityTrack6000_Config.h>
+#include <TrinityTrack6000_MemInfo.h>
+#include <TrinityTrack6000_Placement.h>
+
+/** @name History channels
+ *  @{
+ */
+#define MEMHISTORY_CHANNEL_HEAP  0 /**< Heap used bytes */
+#define MEMHISTORY_CHANNEL_STACK 1 /**< Stack used bytes at the sample */
+#define MEMHISTORY_CHANNEL_BANK  2 /**< First bank, followed by the rest of MEMINFO_BANKS */
+#define MEMHISTORY_CHANNEL_COUNT (MEMHISTORY_CHANNEL_BANK+MEMINFO_BANK_COUNT)
+/** @} */
+
+/**
+ * @brief One history sample
+ */
+typedef struct{
+    uint32_t tick;                            /**< HAL tick of the sample in ms */
+    uint32_t value[MEMHISTORY_CHANNEL_COUNT]; /**< Channel values in bytes */
+}MemSample;
+
+/**
+ * @brief Memory history, kept in RAM2 beside the other diagnostics
+ * @{
+ */
+extern MemSample memHistory_ring[MEMHISTORY_DEPTH]       RAM2_DIAG(memHistory_ring);       /**< Sample ring */
+extern uint32_t memHistory_min[MEMHISTORY_CHANNEL_COUNT] RAM2_DIAG(memHistory_min);        /**< Minimum since init */
+extern uint32_t memHistory_max[MEMHISTORY_CHANNEL_COUNT] RAM2_DIAG(memHistory_max);        /**< Maximum since init */
+extern uint32_t memHistory_sum[MEMHISTORY_CHANNEL_COUNT] RAM2_DIAG(memHistory_sum);        /**< Sum of samples in ring */
+extern uint32_t memHistory_samples                       RAM2_DIAG(memHistory_samples);    /**< Samples taken since init */
+extern uint32_t memHistory_missed                        RAM2_DIAG(memHistory_missed);     /**< Samples skipped while the ring was dumped */
+extern uint32_t memHistory_cyclesLast                    RAM2_DIAG(memHistory_cyclesLast); /**< Cycles of last sample */
+extern uint32_t memHistory_cyclesMax                     RAM2_DIAG(memHistory_cyclesMax);  /**< Worst sample cycles */
+extern uint32_t memHistory_overBudget                    RAM2_DIAG(memHistory_overBudget); /**< Samples above MEMHISTORY_SAMPLE_CYCLES_MAX */
+/** @} */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Initialize memory history.
+ *
+ * Resets the ring and statistics (startup zeroes `.ramDiagnostics`, the
+ * minimums start at UINT32_MAX), sums the static regions of every bank and
+ * enables sampling.
+ * Must be called after `ramDiagnositcsInit()`.
+ */
+void memHistoryInit(void);
+
+/**
+ * @brief Count SysTick interrupts and sample every `MEMHISTORY_PERIOD_MS`.
+ *
+ * Called from `SysTick_Handler()` after `HAL_IncTick()`.
+ */
+void memHistoryTick(void);
+
+/**
+ * @brief Count milliseconds passed without SysTick interrupts.
+ *
+ * Called by tickless idle with interrupts masked (see
+ * TrinityTrack6000_Idle.h). A sample which became due is taken by the next
+ * SysTick interrupt.
+ * @param ms Milliseconds added to `uwTick` after the sleep
+ */
+void memHistoryAdvance(uint32_t ms);
+
+/**
+ * @brief Take one sample.
+ *
+ * Safe to call from any interrupt with priority not higher than SysTick.
+ */
+void memHistorySample(void);
+
+/**
+ * @brief Print history as a time series followed by min/max/avg rows.
+ *
+ * Sampling is paused while the ring is formatted, samples falling into
+ * this time are counted in `memHistory_missed`.
+ */
+void memHistoryDump(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_MEMHISTORY_H_
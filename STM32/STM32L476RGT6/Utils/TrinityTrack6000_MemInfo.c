@@ -1,305 +1,295 @@
 #include <stdint.h>
 #include <string.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <stm32l4xx_hal.h>
 #include <core_cm4.h>
 
 #include <TrinityTrack6000_MemInfo.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Format.h>
 
-extern uint32_t __RAM1_start__; // Defined in the linker script by me for RAM1 start
-extern uint32_t __RAM1_end__;   // Defined in the linker script by me for RAM1 end
+#define MEMINFO_TABLE_WIDTH 72 // Characters between line start and "\r\n"
 
-extern uint32_t _edata;
-extern uint32_t __bss_start__;
-extern uint32_t __bss_end__;
-extern uint32_t _end; // Start of heap as heap grows upwards
-extern uint32_t _heap_start; // Defined in the linker script by me for heap start
-
-extern uint32_t __RAM2_start__; // Defined in the linker script by me for RAM2 start
-extern uint32_t __RAM2_end__; // Defined in the linker script by me for RAM2 end
-
-extern uint32_t __RAM_DIAGNOSTICS_START__; // Defined in the linker script be me for start of ramDiagnostics section in RAM2
-extern uint32_t __RAM_DIAGNOSTICS_END__; // Defined in the linker script by me for end of ramDiagnostics section in RAM2
-
-extern uint32_t __SYS_DIAGNOSTICS_START__; // Defined in the linker scritp be me for start of sysDiag section in RAM2
-extern uint32_t __SYS_DIAGNOSTICS_END__; // Defined in the linker script by me for end of sysDiag section in RAM2
+// Bank and region boundaries, defined in the linker script
+#define MEMINFO_BANK_EXTERN(id,start,end) extern uint32_t start; extern uint32_t end;
+#define MEMINFO_REGION_EXTERN(id,name,bank,start,end,usedEnd,flags) extern uint32_t start; extern uint32_t end;
+MEMINFO_BANKS(MEMINFO_BANK_EXTERN)
+MEMINFO_REGIONS(MEMINFO_REGION_EXTERN)
 
 extern uint8_t* __sbrk_heap_end; // Defined in sysmem.c
 
-extern UART_HandleTypeDef uart;
-
 extern void Error_Handler(void);
 
-const char msg_ramDiagnosticsGeneral_header1[]            ="+-------------------------[ RAM DIAGNOSTICS ]--------------------------+\r\n";
-const char msg_ramDiagnosticsGeneral_header2[]            ="| Bank   | Start      | End        | Size    | Usage      | Used       |\r\n"; 
-const char msg_ramDiagnosticsGeneral_header3[]            ="+--------+------------+------------+---------+------------+------------+\r\n";
-                                                        //  | RAM1   | 0x20000000 | 0x2001FFFF | 128 KB  | ########## | 80%        |
-const char msg_ramDiagnosticsGeneral_formatStringRAM1[]   ="│ RAM1   │ 0x%08lX │ 0x%08lX │ %3u  KB │%11s │ %3u%%       │\r\n";			  
-								                        //  | RAM2   | 0x20020000 | 0x2003FFFF |  64 KB  | ####------| 40%         |
-const char msg_ramDiagnosticsGeneral_formatStringRAM2[]   ="│ RAM2   │ 0x%08lX │ 0x%08lX │ %3u  KB │%11s │ %3u%%       │\r\n";
-								                        //  | CCSRAM | 0x10000000 | 0x10003FFF |  16 KB  | ##--------| 20%         |
-const char msg_ramDiagnosticsGeneral_formatStringCCSRAM[] ="│ CCSRAM │ 0x%08lX │ 0x%08lX │ %3u  KB │%11s │ %3u%%       │\r\n";
-                                                        //  +--------+------------+------------+---------+-----------+-------------+
-                                                        //  | FREE RAM TOTAL: 600 KB                                               |
-const char msg_ramDiagnosticsGeneral_formatStringFreeRAM[]="│ FREE RAM TOTAL: %3u KB                                               │\r\n";
-const char msg_ramDiagnosticsGeneral_footer1[]            ="| Commands: s(snapshot) b(bank) q(quit)                                |\r\n"; 
-const char msg_ramDiagnosticsGeneral_footer2[]            ="+----------------------------------------------------------------------+\r\n";       	
-
-const char msg_ramDiagnosticsRAM1_header1[]               ="+------------------------[ BANK RAM1 DETAILS ]-------------------------+\r\n";
-const char msg_ramDiagnosticsRAM1_header2[]               ="| Section | Start      | End        | Size    | Usage     |            |\r\n"; 
-const char msg_ramDiagnosticsRAM1_header3[]               ="+---------+------------+------------+---------+-----------+------------+\r\n";
-                                                        //  | .DATA   | 0x20000000 | 0x20007FFF | 32 KB   | 32 KB     |            |
-const char msg_ramDiagnosticsRAM1_formatStringData[]      ="| .DATA   | 0x%08lX | 0x%08lX | %3u  KB | %3u  KB   |            |\r\n";			  
-												        //  | .BSS    | 0x20008000 | 0x2000DFFF | 24 KB   | 18 KB     |            |
-const char msg_ramDiagnosticsRAM1_formatStringBSS[]       ="| .BSS    | 0x%08lX | 0x%08lX | %3u  KB | %3u  KB   |            |\r\n";
-												        //  | .TDAT   |   4 KB |   4 KB   | ##-------- | 20%  | N/A                |
-const char msg_ramDiagnosticsRAM1_formatStringTData[]     ="| .TDAT   | 0x%08lX | 0x%08lX | %3u  KB | %3u  KB   |            |\r\n";
-                                                        //  | .HEAP   | 0x2000E000 | 0x2000FFFF | 16 KB   | 8 KB      |            |
-const char msg_ramDiagnosticsRAM1_formatStringHeap[]      ="| .HEAP   | 0x%08lX | 0x%08lX | %3u  KB | %3u  KB   |            |\r\n";
-												        //  | .STACK  | 0x20010000 | 0x20013FFF | 16 KB   | 4 KB      |            |
-const char msg_ramDiagnosticsRAM1_formatStringStack[]     ="| .STACK  | 0x%08lX | 0x%08lX | %3u  KB | %3u  KB   |            |\r\n";
-												        //  +---------+--------+----------+------------+------+--------------------+
-                                                        //  | FREE RAM TOTAL: 60 KB                                                |                                             
-const char msg_ramDiagnosticsRAM1_formatStringFreeRAM[]   ="| FREE RAM TOTAL: %3u KB                                               |\r\n";      			
-                                                        //  | Commands: s(snapshot) b(bank) q(quit)                                |
-														//  +----------------------------------------------------------------------+
-
-const char msg_ramDiagnosticsRAM2_header1[]               ="+------------------------[ BANK RAM2 DETAILS ]-------------------------+\r\n";
-                                                        //  | Section | Start      | End        | Size    | Usage     |            |
-                                                        //  +---------+------------+------------+---------+-----------+------------+
-                                                        //  | .ramDia | 0x10000000 | 0x10004000 |  4 KB   |  4 KB     |            |
-const char msg_ramDiagnosticsRAM2_formatStringRamDia[]    ="| .ramDia | 0x%08lX | 0x%08lX | %3u  KB | %3u  KB   |            |\r\n";
-                                                        //  | .sysDia | 0x10000000 | 0x10004000 |  4 KB   |  4 KB     |            |
-const char msg_ramDiagnosticsRAM2_formatStringSysDia[]    ="| .sysDia | 0x%08lX | 0x%08lX | %3u  KB | %3u  KB   |            |\r\n";			  
-                                                        //  +---------+--------+----------+------------+------+--------------------+
-                                                        //  | FREE RAM TOTAL: 60 KB                                                |                                      
-                                                        //  | Commands: s(snapshot) b(bank) q(quit)                                |
-														//  +----------------------------------------------------------------------+
-
-const char msg_ramDiagnosticsCCSRAM_header1[]             ="+-----------------------[ BANK CCSRAM DETAILS ]------------------------+\r\n";
-                                                        //  | Section | Start      | End        | Size    | Usage     |            |
-                                                        //  +---------+------------+------------+---------+-----------+------------+
-
-														
-uint16_t ramDiagnosticsGeneral_total_size=0;
-uint8_t ramDiagnosticsRAM1_total_size=0;
-uint8_t ramDiagnosticsRAM2_total_size=0;
-uint8_t ramDiagnosticsCCSRAM_total_size=0;
-	
-uint16_t ramDiagnosticsGeneral_used=0;
-uint8_t ramDiagnosticsRAM1_used=0;
-uint8_t ramDiagnosticsRAM2_used=0;
-uint8_t ramDiagnosticsCCSRAM_used=0;
+#define MEMINFO_BANK_ENTRY(id,start,end) {#id,&start,&end},
+#define MEMINFO_REGION_ENTRY(id,name,bank,start,end,usedEnd,flags) {name,MEMINFO_BANK_##bank,flags,&start,&end,usedEnd},
+#define MEMINFO_BANK_CHECK(id,start,end) _Static_assert(sizeof(#id)<=MEMINFO_NAME_SIZE,"Bank name " #id " is too long");
+#define MEMINFO_REGION_CHECK(id,name,bank,start,end,usedEnd,flags) _Static_assert(sizeof(name)<=MEMINFO_NAME_SIZE,"Region name " name " is too long");
+
+MEMINFO_BANKS(MEMINFO_BANK_CHECK)
+MEMINFO_REGIONS(MEMINFO_REGION_CHECK)
+
+const MemBank ramDiagnostics_banks[MEMINFO_BANK_COUNT]={
+	MEMINFO_BANKS(MEMINFO_BANK_ENTRY)
+};
+
+const MemRegion ramDiagnostics_regions[MEMINFO_REGION_COUNT]={
+	MEMINFO_REGIONS(MEMINFO_REGION_ENTRY)
+};
+
+MESSAGE_DEFINE(msg_ramDiagnosticsGeneral_header1,            "+-------------------------[ RAM DIAGNOSTICS ]--------------------------+\r\n");
+MESSAGE_DEFINE(msg_ramDiagnosticsGeneral_header2,            "| Bank   | Start      | End        | Size [B] | Usage      | Used      |\r\n");
+MESSAGE_DEFINE(msg_ramDiagnosticsGeneral_header3,            "+--------+------------+------------+----------+------------+-----------+\r\n");
+                                                        //  | RAM1   | 0x20000000 | 0x20018000 |    98304 | ####------ |  40%      |
+const char msg_ramDiagnosticsGeneral_formatStringBank[]   ="| %-6s | 0x%08lX | 0x%08lX | %8lu | %10s | %3u%%      |\r\n";
+                                                        //  | FREE RAM TOTAL:    78642 B                                           |
+const char msg_ramDiagnosticsGeneral_formatStringFreeRAM[]="| FREE RAM TOTAL: %8lu B                                           |\r\n";
+MESSAGE_DEFINE(msg_ramDiagnosticsGeneral_footer1,            "| s(snap) b(bank) h(hist) a(alloc) k(tasks) c(clock) t(telem) q(quit)  |\r\n");
+MESSAGE_DEFINE(msg_ramDiagnosticsGeneral_footer2,            "+----------------------------------------------------------------------+\r\n");
+
+                                                        //  +------------------------[ BANK RAM1 DETAILS ]-------------------------+
+const char msg_ramDiagnosticsBank_title[]                 ="[ BANK %s DETAILS ]";
+MESSAGE_DEFINE(msg_ramDiagnosticsBank_header2,               "| Section | Start      | End        |  Size [B] |  Used [B] | Usage    |\r\n");
+MESSAGE_DEFINE(msg_ramDiagnosticsBank_header3,               "+---------+------------+------------+-----------+-----------+----------+\r\n");
+                                                        //  | .HEAP   | 0x20000A18 | 0x20001620 |     86504 |      3080 |   3%     |
+const char msg_ramDiagnosticsBank_formatStringRegion[]    ="| %-7s | 0x%08lX | 0x%08lX | %9lu | %9lu | %3u%%     |\r\n";
+
+uint32_t ramDiagnosticsGeneral_total_size=0;
+uint32_t ramDiagnosticsGeneral_used=0;
+uint32_t ramDiagnosticsBank_used[MEMINFO_BANK_COUNT]={0};
+uint32_t ramDiagnosticsRegion_used[MEMINFO_REGION_COUNT]={0};
 
 uint32_t ramDiagnosticsRAM1_lastMSP=0;
 uint32_t ramDiagnosticsRAM1_lastHeapEnd=0;
-uint8_t ramDiagnosticsRAM1_data_size=0;
-uint8_t ramDiagnosticsRAM1_bss_size=0;
-uint8_t ramDiagnosticsRAM1_tdat_size=0;
-uint8_t ramDiagnosticsRAM1_heap_size=0;
-uint8_t ramDiagnosticsRAM1_stack_size=0;
+uint32_t ramDiagnosticsRAM1_stackHighWater=0;
 
-uint8_t ramDiagnosticsRAM2_ramDiagnostics_size=0;
-uint8_t ramDiagnosticsRAM2_sysDiagnostics_size=0;
+// Deepest touched word found so far, NULL until the first scan
+static const uint32_t*ramDiagnostics_stackScanMark=NULL;
 
-void ramDiagnositcsInit(void){
-	ramDiagnosticsRAM1_total_size=((uint32_t)&__RAM1_end__-(uint32_t)&__RAM1_start__)/1024;
-	ramDiagnosticsRAM2_total_size=((uint32_t)&__RAM2_end__-(uint32_t)&__RAM2_start__)/1024;
-	ramDiagnosticsCCSRAM_total_size=0; // Not applicable in this MCU
-	ramDiagnosticsGeneral_total_size=ramDiagnosticsRAM1_total_size+ramDiagnosticsRAM2_total_size+ramDiagnosticsCCSRAM_total_size;
+// Sends line rendered by formatString(), which already limits length to the buffer
+static void ramDiagnosticsSendLine(const char*buffer,uint16_t length){
+	if(length==0){
+		return;
+	}
+	uartTxWrite((const uint8_t*)buffer,length);
+}
 
-	ramDiagnosticsRAM1_data_size=((&_edata-(uint32_t*)&__RAM1_start__)/1024);
-	ramDiagnosticsRAM1_bss_size=((&__bss_end__-(uint32_t*)&__bss_start__)/1024);
-	ramDiagnosticsRAM1_tdat_size=0; // Will be implemented after adding ThreadX to the project
+static uint32_t ramDiagnosticsBankSize(uint8_t bank){
+	return (uint32_t)ramDiagnostics_banks[bank].end-(uint32_t)ramDiagnostics_banks[bank].start;
+}
 
-	ramDiagnosticsRAM2_ramDiagnostics_size=((uint32_t)&__RAM_DIAGNOSTICS_END__-(uint32_t)&__RAM_DIAGNOSTICS_START__)/1024;
-	ramDiagnosticsRAM2_sysDiagnostics_size=((uint32_t)&__SYS_DIAGNOSTICS_END__-(uint32_t)&__SYS_DIAGNOSTICS_END__)/1024;
+static uint8_t ramDiagnosticsPercent(uint32_t used,uint32_t size){
+	if(size==0){
+		return 0;
+	}
+	return (uint8_t)((used*100)/size); // Banks are far below 40 MB, no overflow
+}
 
+// Sends "+----[ title ]----+" line, title is centered
+static void ramDiagnosticsSendTitle(const char*name){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	char*title=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE/2,1);
+	uint16_t titleLength;
+	uint16_t left;
+	uint16_t length=0;
+
+	if(buffer==NULL||title==NULL){
+		arenaRelease(&arena_scratch,mark);
+		return;
+	}
+	titleLength=formatString(title,MEMINFO_LINE_BUFFER_SIZE/2,msg_ramDiagnosticsBank_title,name);
+	left=(MEMINFO_TABLE_WIDTH-2-titleLength)/2;
+
+	buffer[length++]='+';
+	length+=formatPad(&buffer[length],'-',(uint8_t)left);
+	memcpy(&buffer[length],title,titleLength);
+	length+=titleLength;
+	length+=formatPad(&buffer[length],'-',(uint8_t)(MEMINFO_TABLE_WIDTH-1-length));
+	buffer[length++]='+';
+	buffer[length++]='\r';
+	buffer[length++]='\n';
+
+	ramDiagnosticsSendLine(buffer,length);
+	arenaRelease(&arena_scratch,mark);
+}
+
+void ramDiagnositcsInit(void){
+	ramDiagnosticsGeneral_total_size=0;
+	for(uint8_t bank=0;bank<MEMINFO_BANK_COUNT;bank++){
+		ramDiagnosticsGeneral_total_size+=ramDiagnosticsBankSize(bank);
+	}
 	ramDiagnosticsRefresh();
 }
-void ramDiagnosticsRefresh(){
-// RAM1 heap usage
+
+void ramDiagnosticsRefresh(void){
+	const MemRegion*region=ramDiagnostics_regions;
+
+	ramDiagnosticsRAM1_lastMSP=__get_MSP();
+	memset(ramDiagnosticsBank_used,0,sizeof(ramDiagnosticsBank_used));
+	ramDiagnosticsGeneral_used=0;
+
+	for(uint8_t i=0;i<MEMINFO_REGION_COUNT;i++,region++){
+		uint32_t start=(uint32_t)region->start;
+		uint32_t end=(uint32_t)region->end;
+		uint32_t used=end-start;
+
+		if(region->usedEnd!=NULL){
+			uint32_t boundary=region->usedEnd();
+
+			used=(region->flags&MEMINFO_REGION_GROWS_DOWN)?end-boundary:boundary-start;
+		}
+		ramDiagnosticsRegion_used[i]=used;
+		ramDiagnosticsBank_used[region->bank]+=used;
+		ramDiagnosticsGeneral_used+=used;
+	}
+}
+
+uint32_t ramDiagnosticsHeapEnd(void){
 	if(__sbrk_heap_end==NULL){
 		ramDiagnosticsRAM1_lastHeapEnd=(uint32_t)&_end;
 	}
 	else{
 		ramDiagnosticsRAM1_lastHeapEnd=(uint32_t)__sbrk_heap_end;
 	}
+	return ramDiagnosticsRAM1_lastHeapEnd;
+}
 
-// RAM1 usage
-	ramDiagnosticsRAM1_lastMSP=__get_MSP();
-	ramDiagnosticsRAM1_used=(((uint32_t)&__RAM1_end__-ramDiagnosticsRAM1_lastMSP)+(ramDiagnosticsRAM1_lastHeapEnd-(uint32_t)&__RAM1_start__))/1024;
-// RAM2 usage
-	ramDiagnosticsRAM2_used=((uint32_t)&__RAM_DIAGNOSTICS_END__-(uint32_t)&__RAM2_start__)/1024;
-// CCSRAM usage
-	// Not applicable in this MCU
-// General RAM usage
-	ramDiagnosticsGeneral_used=ramDiagnosticsRAM1_used+ramDiagnosticsRAM2_used+ramDiagnosticsCCSRAM_used;
-// RAM1 .heap section usage
-	ramDiagnosticsRAM1_heap_size=((uint32_t)ramDiagnosticsRAM1_lastHeapEnd-(uint32_t)&_end)/1024;
-// RAM1 .stack section usage
-	ramDiagnosticsRAM1_stack_size=((uint32_t)&__RAM1_end__-ramDiagnosticsRAM1_lastMSP)/1024;
-//
+uint32_t ramDiagnosticsStackHighWater(void){
+	ramDiagnosticsStackScan();
+	return ramDiagnosticsRAM1_stackHighWater;
 }
-														
-void ramDiagnosticsGeneral(){
-	char buffer[MEMINFO_LINE_BUFFER_SIZE]={0};
-	char bar_buffer[MEMINFO_BAR_BUFFER_SIZE]={0};
 
-	uint8_t usage_percent=0; // Used for bar graph calculation
-// Send General RAM diagnostics headers 1-3
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsGeneral_header1,strlen(msg_ramDiagnosticsGeneral_header1),MEMINFO_UART_TIMEOUT);
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsGeneral_header2,strlen(msg_ramDiagnosticsGeneral_header2),MEMINFO_UART_TIMEOUT);
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsGeneral_header3,strlen(msg_ramDiagnosticsGeneral_header3),MEMINFO_UART_TIMEOUT);
-// Send RAM1 info
-	usage_percent=((uint16_t)ramDiagnosticsRAM1_used*100)/ramDiagnosticsRAM1_total_size;
-	memset(bar_buffer,'-',MEMINFO_BAR_BUFFER_SIZE-1);
-	bar_buffer[MEMINFO_BAR_BUFFER_SIZE-1]='\0';
-
-	if(usage_percent>100){
-		// Add error code here
-		Error_Handler(); // this should never happen
-	}
+uint32_t ramDiagnosticsStackScan(void){
+	const uint32_t*limit=ramDiagnostics_stackScanMark;
+	const uint32_t*mark=(const uint32_t*)&_sstack;
 
-	memset(bar_buffer,'#',(usage_percent*MEMINFO_BAR_BUFFER_SIZE)/100);
-	bar_buffer[MEMINFO_BAR_BUFFER_SIZE-1]='\0';
-	snprintf(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsGeneral_formatStringRAM1,
-		(uint32_t)&__RAM1_start__,	   // RAM1 start
-		(uint32_t)&__RAM1_end__,       // RAM1 end
-		ramDiagnosticsRAM1_total_size, // RAM1 size in KB
-		bar_buffer,                    // RAM1 usage bar
-		usage_percent                  // RAM1 usage percent
-	);
-	HAL_UART_Transmit(&uart,(uint8_t*)buffer,strlen(buffer),MEMINFO_UART_TIMEOUT);
-// Send RAM2 info
-	usage_percent=((uint16_t)ramDiagnosticsRAM2_used*100)/ramDiagnosticsRAM2_total_size;
-	memset(bar_buffer,'-',MEMINFO_BAR_BUFFER_SIZE-1);
-	bar_buffer[MEMINFO_BAR_BUFFER_SIZE-1]='\0';
-
-	if(usage_percent>100){
-		// Add error code here
-		Error_Handler(); // this should never happen
+	if(limit==NULL){
+		limit=(const uint32_t*)&_estack;
+	}
+	// Upwards from the bottom to the first touched word, the cached mark ends the scan
+	while(mark<limit&&*mark==STACK_PAINT_PATTERN){
+		mark++;
 	}
+	ramDiagnostics_stackScanMark=mark;
+	ramDiagnosticsRAM1_stackHighWater=(uint32_t)mark;
 
-	memset(bar_buffer,'#',(usage_percent*MEMINFO_BAR_BUFFER_SIZE)/100);
-	bar_buffer[MEMINFO_BAR_BUFFER_SIZE-1]='\0';
-	snprintf(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsGeneral_formatStringRAM2,
-		(uint32_t)&__RAM2_start__,	   // RAM2 start
-		(uint32_t)&__RAM2_end__,       // RAM2 end
-		ramDiagnosticsRAM2_total_size, // RAM2 size in KB
-		bar_buffer,                    // RAM2 usage bar
-		usage_percent                  // RAM2 usage percent
-	);
-	HAL_UART_Transmit(&uart,(uint8_t*)buffer,strlen(buffer),MEMINFO_UART_TIMEOUT);
-// Send CCSRAM info
-	// Not applicable in this MCU
-	// Will be added in production project with STM32G473
+	return (uint32_t)&_estack-(uint32_t)mark;
+}
+
+void ramDiagnosticsGeneral(void){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	uint16_t length=0;
+	char*bar_buffer=arenaAlloc(&arena_scratch,MEMINFO_BAR_BUFFER_SIZE,1);
+
+	uint8_t usage_percent=0; // Used for bar graph calculation
+
+	if(buffer==NULL||bar_buffer==NULL){
+		arenaRelease(&arena_scratch,mark);
+		return;
+	}
+// Send General RAM diagnostics headers 1-3
+	uartTxWriteMessage(&msg_ramDiagnosticsGeneral_header1);
+	uartTxWriteMessage(&msg_ramDiagnosticsGeneral_header2);
+	uartTxWriteMessage(&msg_ramDiagnosticsGeneral_header3);
+// Send info of every bank
+	for(uint8_t bank=0;bank<MEMINFO_BANK_COUNT;bank++){
+		usage_percent=ramDiagnosticsPercent(ramDiagnosticsBank_used[bank],ramDiagnosticsBankSize(bank));
+
+		if(usage_percent>100){
+			// Add error code here
+			Error_Handler(); // this should never happen
+		}
+
+		formatBar(bar_buffer,usage_percent,MEMINFO_BAR_BUFFER_SIZE-1);
+		bar_buffer[MEMINFO_BAR_BUFFER_SIZE-1]='\0';
+		length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsGeneral_formatStringBank,
+			ramDiagnostics_banks[bank].name,              // Bank name
+			(uint32_t)ramDiagnostics_banks[bank].start,   // Bank start
+			(uint32_t)ramDiagnostics_banks[bank].end,     // Bank end
+			ramDiagnosticsBankSize(bank),                 // Bank size in bytes
+			bar_buffer,                                   // Bank usage bar
+			usage_percent                                 // Bank usage percent
+		);
+		ramDiagnosticsSendLine(buffer,length);
+	}
 // Send RAM diagnostics header 4
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsGeneral_header3,strlen(msg_ramDiagnosticsGeneral_header3),MEMINFO_UART_TIMEOUT);
+	uartTxWriteMessage(&msg_ramDiagnosticsGeneral_header3);
 // Send Free RAM total
-	snprintf(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsGeneral_formatStringFreeRAM,ramDiagnosticsGeneral_total_size-ramDiagnosticsGeneral_used);
-	HAL_UART_Transmit(&uart,(uint8_t*)buffer,strlen(buffer),MEMINFO_UART_TIMEOUT);
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsGeneral_formatStringFreeRAM,
+		ramDiagnosticsGeneral_total_size-ramDiagnosticsGeneral_used);
+	ramDiagnosticsSendLine(buffer,length);
 // Send RAM diagnostics footers
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsGeneral_footer1,strlen(msg_ramDiagnosticsGeneral_footer1),MEMINFO_UART_TIMEOUT);
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsGeneral_footer2,strlen(msg_ramDiagnosticsGeneral_footer2),MEMINFO_UART_TIMEOUT);
+	uartTxWriteMessage(&msg_ramDiagnosticsGeneral_footer1);
+	uartTxWriteMessage(&msg_ramDiagnosticsGeneral_footer2);
 // Send empty line
-	HAL_UART_Transmit(&uart,(uint8_t*)"\r\n",2,MEMINFO_UART_TIMEOUT);	
+	uartTxWrite((const uint8_t*)"\r\n",2);
+	arenaRelease(&arena_scratch,mark);
 }
 
-void ramDiagnosticsRAM1(){
-	char buffer[MEMINFO_LINE_BUFFER_SIZE]={0};
-
-// Send RAM1 diagnostics headers 1-3	
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsRAM1_header1,strlen(msg_ramDiagnosticsRAM1_header1),MEMINFO_UART_TIMEOUT);
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsRAM1_header2,strlen(msg_ramDiagnosticsRAM1_header2),MEMINFO_UART_TIMEOUT);
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsRAM1_header3,strlen(msg_ramDiagnosticsRAM1_header3),MEMINFO_UART_TIMEOUT);
-// Send .data section info
-	snprintf(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsRAM1_formatStringData,
-		(uint32_t)&__RAM1_start__,	    // .data start
-		(uint32_t)&_edata,              // .data end
-		ramDiagnosticsRAM1_data_size,   // .data size in KB
-		ramDiagnosticsRAM1_data_size    // .data used size in KB
-	);
-	HAL_UART_Transmit(&uart,(uint8_t*)buffer,strlen(buffer),MEMINFO_UART_TIMEOUT);
-// Send .bss section info
-	snprintf(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsRAM1_formatStringBSS,
-		(uint32_t)&__bss_start__,		 // .bss start
-		(uint32_t)&__bss_end__,          // .bss end
-		ramDiagnosticsRAM1_bss_size,     // .bss size in KB
-		ramDiagnosticsRAM1_bss_size      // .bss used size in KB
-	);
-	HAL_UART_Transmit(&uart,(uint8_t*)buffer,strlen(buffer),MEMINFO_UART_TIMEOUT);
-// Send .tdat section info
-	snprintf(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsRAM1_formatStringTData,
-		0UL,                             // .tdat start
-		0UL,							 // .tdat end
-		ramDiagnosticsRAM1_tdat_size,    // .tdat size in KB
-		ramDiagnosticsRAM1_tdat_size     // .tdat used size in KB
-	);
-	HAL_UART_Transmit(&uart,(uint8_t*)buffer,strlen(buffer),MEMINFO_UART_TIMEOUT);
-// Send .heap section info
-	snprintf(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsRAM1_formatStringHeap,
-		(uint32_t)&_end,                          // .heap start
-		(uint32_t)ramDiagnosticsRAM1_lastHeapEnd, // .heap end
-		ramDiagnosticsRAM1_heap_size,             // .heap size in KB
-		ramDiagnosticsRAM1_heap_size              // .heap used size in KB
-	);
-	HAL_UART_Transmit(&uart,(uint8_t*)buffer,strlen(buffer),MEMINFO_UART_TIMEOUT);
-// Send .stack section info
-	snprintf(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsRAM1_formatStringStack,
-		(uint32_t)&__RAM1_end__,              // .stack start
-		(uint32_t)ramDiagnosticsRAM1_lastMSP, // .stack end
-		ramDiagnosticsRAM1_stack_size,        // .stack size in KB
-		ramDiagnosticsRAM1_stack_size         // .stack used size in KB
-	);
-	HAL_UART_Transmit(&uart,(uint8_t*)buffer,strlen(buffer),MEMINFO_UART_TIMEOUT);
-// Send RAM1 diagnostics footers
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsRAM1_header3,strlen(msg_ramDiagnosticsRAM1_header3),MEMINFO_UART_TIMEOUT);
-	
-// Send Free RAM total
-	snprintf(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsRAM1_formatStringFreeRAM,ramDiagnosticsRAM1_total_size-ramDiagnosticsRAM1_used);
-	HAL_UART_Transmit(&uart,(uint8_t*)buffer,strlen(buffer),MEMINFO_UART_TIMEOUT);
+void ramDiagnosticsBank(uint8_t bank){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer;
+	uint16_t length=0;
+	const MemRegion*region=ramDiagnostics_regions;
 
+	if(bank>=MEMINFO_BANK_COUNT){
+		return;
+	}
+	buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	if(buffer==NULL){
+		return;
+	}
+// Send bank diagnostics headers 1-3
+	ramDiagnosticsSendTitle(ramDiagnostics_banks[bank].name);
+	uartTxWriteMessage(&msg_ramDiagnosticsBank_header2);
+	uartTxWriteMessage(&msg_ramDiagnosticsBank_header3);
+// Send info of every region in the bank, start and end show the used part
+	for(uint8_t i=0;i<MEMINFO_REGION_COUNT;i++,region++){
+		uint32_t start=(uint32_t)region->start;
+		uint32_t end=(uint32_t)region->end;
+		uint32_t size=end-start;
+
+		if(region->bank!=bank){
+			continue;
+		}
+		if(region->flags&MEMINFO_REGION_GROWS_DOWN){
+			start=end-ramDiagnosticsRegion_used[i];
+		}
+		else{
+			end=start+ramDiagnosticsRegion_used[i];
+		}
+		length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsBank_formatStringRegion,
+			region->name,                                              // Region name
+			start,                                                     // Used part start
+			end,                                                       // Used part end
+			size,                                                      // Region size in bytes
+			ramDiagnosticsRegion_used[i],                              // Region used bytes
+			ramDiagnosticsPercent(ramDiagnosticsRegion_used[i],size)   // Region usage percent
+		);
+		ramDiagnosticsSendLine(buffer,length);
+	}
+// Send bank diagnostics footers
+	uartTxWriteMessage(&msg_ramDiagnosticsBank_header3);
+// Send free RAM in bank
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsGeneral_formatStringFreeRAM,
+		ramDiagnosticsBankSize(bank)-ramDiagnosticsBank_used[bank]);
+	ramDiagnosticsSendLine(buffer,length);
 // Send RAM diagnostics footers
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsGeneral_footer1,strlen(msg_ramDiagnosticsGeneral_footer1),MEMINFO_UART_TIMEOUT);
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsGeneral_footer2,strlen(msg_ramDiagnosticsGeneral_footer2),MEMINFO_UART_TIMEOUT);
+	uartTxWriteMessage(&msg_ramDiagnosticsGeneral_footer1);
+	uartTxWriteMessage(&msg_ramDiagnosticsGeneral_footer2);
+	arenaRelease(&arena_scratch,mark);
 }
 
-void ramDiagnosticsRAM2(){
-	char buffer[MEMINFO_LINE_BUFFER_SIZE]={0};
-// Send RAM2 diagnostics headers 1-3
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsRAM2_header1,strlen(msg_ramDiagnosticsRAM2_header1),MEMINFO_UART_TIMEOUT);
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsRAM1_header2,strlen(msg_ramDiagnosticsRAM1_header2),MEMINFO_UART_TIMEOUT);
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsRAM1_header3,strlen(msg_ramDiagnosticsRAM1_header3),MEMINFO_UART_TIMEOUT);
-// Send .ramDiagnostics section info
-	snprintf(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsRAM2_formatStringRamDia,
-		(uint32_t)&__RAM_DIAGNOSTICS_START__,	     // .ramDiagnostics start
-		(uint32_t)&__RAM_DIAGNOSTICS_END__,          // .ramDiagnostics end
-		ramDiagnosticsRAM2_ramDiagnostics_size,      // .ramDiagnostics size in KB
-		ramDiagnosticsRAM2_ramDiagnostics_size       // .ramDiagnostics used size in KB
-	);
-	HAL_UART_Transmit(&uart,(uint8_t*)buffer,strlen(buffer),MEMINFO_UART_TIMEOUT);
-// Send .sysDiag section info
-	snprintf(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsRAM2_formatStringSysDia,
-		(uint32_t)&__SYS_DIAGNOSTICS_START__,        // .sysDiag start
-		(uint32_t)&__SYS_DIAGNOSTICS_END__,          // .sysDiag end
-		ramDiagnosticsRAM2_sysDiagnostics_size,      // .sysDiag size in KB
-		ramDiagnosticsRAM2_sysDiagnostics_size       // .sysDiag size in KB
-	);
-	HAL_UART_Transmit(&uart,(uint8_t*)buffer,strlen(buffer),MEMINFO_UART_TIMEOUT);	
-// Send RAM2 diagnostics footers
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsRAM1_header3,strlen(msg_ramDiagnosticsRAM1_header3),MEMINFO_UART_TIMEOUT);
-// Send Free RAM total
-	snprintf(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramDiagnosticsRAM1_formatStringFreeRAM,ramDiagnosticsRAM2_total_size-ramDiagnosticsRAM2_used);
-	HAL_UART_Transmit(&uart,(uint8_t*)buffer,strlen(buffer),MEMINFO_UART_TIMEOUT);
-// Send RAM diagnostics footers
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsGeneral_footer1,strlen(msg_ramDiagnosticsGeneral_footer1),MEMINFO_UART_TIMEOUT);
-	HAL_UART_Transmit(&uart,(uint8_t*)msg_ramDiagnosticsGeneral_footer2,strlen(msg_ramDiagnosticsGeneral_footer2),MEMINFO_UART_TIMEOUT);
+void ramDiagnosticsRAM1(void){
+	ramDiagnosticsBank(MEMINFO_BANK_RAM1);
 }
 
-void ramDiagnosticsCCSRAM(){
-	// Not applicable in this MCU
-	// Will be added in production project with STM32G473
+void ramDiagnosticsRAM2(void){
+	ramDiagnosticsBank(MEMINFO_BANK_RAM2);
 }
 
+void ramDiagnosticsCCSRAM(void){
+	// Not applicable in this MCU
+	// Will be added in production project with STM32G473 as a MEMINFO_BANKS entry
+}
@@ -2,23 +2,32 @@
  * @file TrinityTrack6000_MemInfo.h
  * @brief RAM diagnostics interface for TrinityTrack6000 project.
  *
- * This module provides functions and variables for monitoring and 
- * reporting memory usage across different RAM banks (RAM1, RAM2, CCSRAM). 
- * It defines diagnostics headers/footers, format strings for 
- * generating ASCII reports, and dedicated variables stored in 
- * `.ramDiagnostics` linker sections to track memory sizes and usage.
+ * This module provides functions and variables for monitoring and
+ * reporting memory usage across different RAM banks (RAM1, RAM2, CCSRAM).
+ * Memory is described by two tables built from linker symbols:
+ * - `MEMINFO_BANKS` RAM banks with their start and end
+ * - `MEMINFO_REGIONS` sections inside banks, with an optional callback
+ *   returning the dynamic end of the used part (heap end, stack high-water mark)
+ *
+ * All sizes are 32 bit byte counts. Usage variables are kept in the
+ * `.ramDiagnostics` linker section in RAM2. Adding a section to the reports
+ * (e.g. `.tdat` or `.crit`) takes one `MEMINFO_REGIONS` entry, refresh,
+ * reports and telemetry are generic.
+ * Format strings are rendered by `formatString()`, which checks them
+ * against the arguments at compile time and does not need newlib `vfprintf()`.
  *
  * Features:
  * - Initialization and refresh of memory usage information
  * - General RAM diagnostics overview
- * - Per-bank diagnostics for RAM1, RAM2, and CCSRAM
+ * - Per-bank diagnostics rendered by one generic function
  * - Tracking of heap and stack pointers in RAM1
- * - Allocation of diagnostic variables in separate linker sections
+ * - Stack high-water mark, startup paints the stack budget with
+ *   `STACK_PAINT_PATTERN` and `ramDiagnosticsStackScan()` finds the deepest touched word
  *
  * Usage:
- * - Call `ramDiagnositcsInit()` during system initialization to set up total sizes
+ * - Call `ramDiagnositcsInit()` during system initialization
  * - Call `ramDiagnosticsRefresh()` on-demand or periodically to update usage data
- * - Use `ramDiagnosticsGeneral()`, `ramDiagnosticsRAM1()`, etc. to print details
+ * - Use `ramDiagnosticsGeneral()`, `ramDiagnosticsBank()` etc. to print details
  *
  * @date 2025.09.08
  * @author Alan Kudełko
@@ -26,66 +35,117 @@
 #ifndef _TRINITYTRACK6000_MEMINFO_H_
     #define _TRINITYTRACK6000_MEMINFO_H_
 
-#define MEMINFO_UART_TIMEOUT 1000
+#include <stdint.h>
+
+#include <TrinityTrack6000_Message.h>
+#include <TrinityTrack6000_Pool.h>
+#include <TrinityTrack6000_Arena.h>
+#include <TrinityTrack6000_Placement.h>
+
 #define MEMINFO_LINE_BUFFER_SIZE 90
 #define MEMINFO_BAR_BUFFER_SIZE 11
+#define MEMINFO_NAME_SIZE 8 /**< Maximum length of bank and region names including NUL */
 
-/** @name Headers and footers for RAM memory dumps
- *  @{
- */
-extern const char msg_ramDiagnosticsGeneral_header1[];  /**< General RAM diagnostics header line 1 */
-extern const char msg_ramDiagnosticsGeneral_header2[];  /**< General RAM diagnostics header line 2 */
-extern const char msg_ramDiagnosticsGeneral_header3[];  /**< General RAM diagnostics header line 3 */
-extern const char msg_ramDiagnosticsGeneral_formatStringRAM1[];  /**< General RAM diagnostics format string for RAM1 */
-extern const char msg_ramDiagnosticsGeneral_formatStringRAM2[];  /**< General RAM diagnostics format string for RAM2 */
-extern const char msg_ramDiagnosticsGeneral_formatStringCCSRAM[];  /**< General RAM diagnostics format string for CCSRAM */
-extern const char msg_ramDiagnosticsGeneral_formatStringFreeRAM[];  /**< General RAM diagnostics format string for free RAM */
-extern const char msg_ramDiagnosticsGeneral_footer1[];  /**< General RAM diagnostics footer line 1 */
-extern const char msg_ramDiagnosticsGeneral_footer2[];  /**< General RAM diagnostics footer line 2 */
+#define STACK_PAINT_PATTERN 0xC5C5C5C5u /**< Pattern of unused stack words, keep in sync with startup code */
 
-extern const char msg_ramDiagnosticsRAM1_header1[];  /**< RAM1 diagnostics header line 1 */
-extern const char msg_ramDiagnosticsRAM1_header2[];  /**< RAM1 diagnostics header line 2 */
-extern const char msg_ramDiagnosticsRAM1_header3[];  /**< RAM1 diagnostics header line 3 */
+/**
+ * @brief RAM banks X(id,startSymbol,endSymbol)
+ *
+ * CCSRAM is not present in STM32L476, add X(CCSRAM,...) for STM32G473.
+ */
+#define MEMINFO_BANKS(X) \
+    X(RAM1,__RAM1_start__,__RAM1_end__) \
+    X(RAM2,__RAM2_start__,__RAM2_end__)
 
-extern const char msg_ramDiagnosticsRAM1_formatStringData[];   /**< RAM1 diagnostics format string for .data section */
-extern const char msg_ramDiagnosticsRAM1_formatStringBSS[];    /**< RAM1 diagnostics format string for .bss section */
-extern const char msg_ramDiagnosticsRAM1_formatStringHeap[];   /**< RAM1 diagnostics format string for .heap section */
-extern const char msg_ramDiagnosticsRAM1_formatStringStack[];  /**< RAM1 diagnostics format string for .stack section */
+/**
+ * @brief Regions of banks X(id,name,bank,startSymbol,endSymbol,usedEnd,flags)
+ *
+ * Without `usedEnd` callback the whole region is used. Regions with
+ * `MEMINFO_REGION_GROWS_DOWN` are used from usedEnd() up to endSymbol.
+ */
+#define MEMINFO_REGIONS(X) \
+    X(DATA,  ".DATA",  RAM1,_sdata,                   _edata,                  NULL,                        0) \
+    X(BSS,   ".BSS",   RAM1,__bss_start__,            __bss_end__,             NULL,                        0) \
+    X(POOL,  ".POOL",  RAM1,__POOL_START__,           __POOL_END__,            poolUsedEnd,                 0) \
+    X(ARENA, ".ARENA", RAM1,__ARENA_START__,          __ARENA_END__,           arenaUsedEnd,                0) \
+    X(TDAT,  ".TDAT",  RAM1,__TDAT_START__,           __TDAT_END__,            NULL,                        0) \
+    X(HEAP,  ".HEAP",  RAM1,_end,                     _sstack,                 ramDiagnosticsHeapEnd,       0) \
+    X(STACK, ".STACK", RAM1,_sstack,                  _estack,                 ramDiagnosticsStackHighWater,MEMINFO_REGION_GROWS_DOWN) \
+    X(NOINIT,".noinit",RAM2,__NOINIT_START__,         __NOINIT_END__,          NULL,                        0) \
+    X(HOT,   ".hot",   RAM2,_sram2_text,              _eram2_data,             NULL,                        0) \
+    X(RAMDIA,".ramDia",RAM2,__RAM_DIAGNOSTICS_START__,__RAM_DIAGNOSTICS_END__, NULL,                        0) \
+    X(SYSDIA,".sysDia",RAM2,__SYS_DIAGNOSTICS_START__,__SYS_DIAGNOSTICS_END__, NULL,                        0) \
+    X(LOGBUF,".logBuf",RAM2,__LOG_BUFFER_START__,     __LOG_BUFFER_END__,      NULL,                        0) \
+    X(CRIT,  ".crit",  RAM2,__CRIT_START__,           __CRIT_END__,            NULL,                        0)
+
+#define MEMINFO_REGION_GROWS_DOWN 0x01 /**< Region is used from its end downwards (stack) */
+
+#define MEMINFO_BANK_ID(id,start,end) MEMINFO_BANK_##id,
+#define MEMINFO_REGION_ID(id,name,bank,start,end,usedEnd,flags) MEMINFO_REGION_##id,
+
+enum{
+    MEMINFO_BANKS(MEMINFO_BANK_ID)
+    MEMINFO_BANK_COUNT
+};
+
+enum{
+    MEMINFO_REGIONS(MEMINFO_REGION_ID)
+    MEMINFO_REGION_COUNT
+};
 
-extern const char msg_ramDiagnosticsRAM1_formatStringFreeRAM[];  /**< RAM1 diagnostics format string for free RAM */
+/**
+ * @brief RAM bank descriptor
+ */
+typedef struct{
+    const char*name;   /**< Bank name used in reports */
+    const void*start;  /**< First byte of bank */
+    const void*end;    /**< First byte after bank */
+}MemBank;
 
+/**
+ * @brief Region descriptor
+ */
+typedef struct{
+    const char*name;            /**< Section name used in reports */
+    uint8_t bank;               /**< One of MEMINFO_BANK_* */
+    uint8_t flags;              /**< MEMINFO_REGION_* flags */
+    const void*start;           /**< First byte of region */
+    const void*end;             /**< First byte after region */
+    uint32_t(*usedEnd)(void);   /**< Dynamic end of used part or NULL if region is fully used */
+}MemRegion;
+
+extern const MemBank ramDiagnostics_banks[MEMINFO_BANK_COUNT];       /**< Bank table */
+extern const MemRegion ramDiagnostics_regions[MEMINFO_REGION_COUNT]; /**< Region table */
 
-extern const char msg_ramDiagnosticsRAM2_header1[]; /**< RAM2 diagnostics header line 1 */
-extern const char msg_ramDiagnosticsRAM2_formatStringRamDia[]; /**< RAM2 diagnostics format string for .ramDiagnostics section */
-extern const char msg_ramDiagnosticsRAM2_formatStringSysDia[]; /**< RAM2 diagnostics format string for .sysDiag section */
+/** @name Headers and footers for RAM memory dumps
+ *  @{
+ */
+extern const Message msg_ramDiagnosticsGeneral_header1;  /**< General RAM diagnostics header line 1 */
+extern const Message msg_ramDiagnosticsGeneral_header2;  /**< General RAM diagnostics header line 2 */
+extern const Message msg_ramDiagnosticsGeneral_header3;  /**< General RAM diagnostics header line 3 */
+extern const char msg_ramDiagnosticsGeneral_formatStringBank[];     /**< General RAM diagnostics format string for a bank */
+extern const char msg_ramDiagnosticsGeneral_formatStringFreeRAM[];  /**< General RAM diagnostics format string for free RAM */
+extern const Message msg_ramDiagnosticsGeneral_footer1;  /**< General RAM diagnostics footer line 1 */
+extern const Message msg_ramDiagnosticsGeneral_footer2;  /**< General RAM diagnostics footer line 2 */
 
-extern const char msg_ramDiagnosticsCCSRAM_header1[]; /**< CCSRAM diagnostics header line 1 */
+extern const char msg_ramDiagnosticsBank_title[];        /**< Bank details title, centered in header line 1 */
+extern const Message msg_ramDiagnosticsBank_header2;     /**< Bank details header line 2 */
+extern const Message msg_ramDiagnosticsBank_header3;     /**< Bank details header line 3 */
+extern const char msg_ramDiagnosticsBank_formatStringRegion[];   /**< Bank details format string for a region */
 /** @} */
 
 /**
- * @brief RAM diagnostics variables
+ * @brief RAM diagnostics variables, all sizes in bytes
  * @{
  */
-extern uint16_t ramDiagnosticsGeneral_total_size __attribute((section(".ramDiagnostics.uint16_t"))); /**<  Total size of all RAM in kB */
-extern uint8_t ramDiagnosticsRAM1_total_size     __attribute((section(".ramDiagnostics.uint8_t"))); /**<  Total size of bank RAM1 in kB */
-extern uint8_t ramDiagnosticsRAM2_total_size     __attribute((section(".ramDiagnostics.uint8_t"))); /**<  Total size of bank RAM2 in kB */
-extern uint8_t ramDiagnosticsCCSRAM_total_size   __attribute((section(".ramDiagnostics.uint8_t"))); /**<  Total size of bank CCSRAM in kB */
-
-extern uint16_t ramDiagnosticsGeneral_used       __attribute((section(".ramDiagnostics.uint16_t"))); /**<  Total amount of used RAM memory kB */
-extern uint8_t ramDiagnosticsRAM1_used           __attribute((section(".ramDiagnostics.uint8_t")));   /**<  Amount of used memory in bank RAM1 kB */
-extern uint8_t ramDiagnosticsRAM2_used           __attribute((section(".ramDiagnostics.uint8_t")));   /**<  Amount of used memory in bank RAM2 kB */
-extern uint8_t ramDiagnosticsCCSRAM_used         __attribute((section(".ramDiagnostics.uint8_t"))); /**<  Amount of used memory in bank CCSRAM kB */
-
-extern uint32_t ramDiagnosticsRAM1_lastMSP       __attribute((section(".ramDiagnostics.uint32_t")));  /**<  Last value of Main Stack Pointer in RAM1 */
-extern uint32_t ramDiagnosticsRAM1_lastHeapEnd   __attribute((section(".ramDiagnostics.uint32_t"))); /**<  Last value of heap end pointer in RAM1 */
-extern uint8_t ramDiagnosticsRAM1_data_size      __attribute((section(".ramDiagnostics.uint8_t")));  /**<  Size of .data section in RAM1 */
-extern uint8_t ramDiagnosticsRAM1_bss_size       __attribute((section(".ramDiagnostics.uint8_t")));   /**<  Size of .bss section in RAM1 */
-extern uint8_t ramDiagnosticsRAM1_tdat_size      __attribute((section(".ramDiagnostics.uint8_t")));  /**<  Size of .tdat section in RAM1 */
-extern uint8_t ramDiagnosticsRAM1_heap_size      __attribute((section(".ramDiagnostics.uint8_t")));  /**<  Size of .heap section in RAM1 */
-extern uint8_t ramDiagnosticsRAM1_stack_size     __attribute((section(".ramDiagnostics.uint8_t"))); /**<  Size of .stack section in RAM1 */
-
-extern uint8_t ramDiagnosticsRAM2_ramDiagnostics_size __attribute((section(".ramDiagnostics.uint8_t"))); /**< Size of .ramDiagnostics section in RAM2 */
-extern uint8_t ramDiagnosticsRAM2_sysDiagnostics_size __attribute((section(".ramDiagnostics.uint8_t"))); /**< Size of .sysDiagnostics section in RAM2 */
+extern uint32_t ramDiagnosticsGeneral_total_size                RAM2_DIAG(ramDiagnosticsGeneral_total_size); /**<  Total size of all RAM */
+extern uint32_t ramDiagnosticsGeneral_used                      RAM2_DIAG(ramDiagnosticsGeneral_used);       /**<  Total amount of used RAM */
+extern uint32_t ramDiagnosticsBank_used[MEMINFO_BANK_COUNT]     RAM2_DIAG(ramDiagnosticsBank_used);          /**< Used memory per bank */
+extern uint32_t ramDiagnosticsRegion_used[MEMINFO_REGION_COUNT] RAM2_DIAG(ramDiagnosticsRegion_used);        /**< Used memory per region */
+
+extern uint32_t ramDiagnosticsRAM1_lastMSP        RAM2_DIAG(ramDiagnosticsRAM1_lastMSP);        /**<  Last value of Main Stack Pointer in RAM1 */
+extern uint32_t ramDiagnosticsRAM1_lastHeapEnd    RAM2_DIAG(ramDiagnosticsRAM1_lastHeapEnd);    /**<  Last value of heap end pointer in RAM1 */
+extern uint32_t ramDiagnosticsRAM1_stackHighWater RAM2_DIAG(ramDiagnosticsRAM1_stackHighWater); /**<  Lowest stack address ever touched in RAM1 */
 /** @} */
 
 #ifdef __cplusplus
@@ -95,8 +155,8 @@ extern uint8_t ramDiagnosticsRAM2_sysDiagnostics_size __attribute((section(".ram
 /**
  * @brief Initialize RAM diagnostics.
  *
- * Calculates the total sizes of all RAM banks and refreshes the current usage.  
- * This function should be called once during system initialization 
+ * Calculates the total size of all RAM banks and refreshes the current usage.
+ * This function should be called once during system initialization
  * (e.g., inside `initializeSystem()`).
  */
 void ramDiagnositcsInit(void);
@@ -104,42 +164,69 @@ void ramDiagnositcsInit(void);
 /**
  * @brief Refresh RAM diagnostics data.
  *
- * Updates the usage information for all RAM banks (RAM1, RAM2, CCSRAM).  
- * Should be called periodically or on-demand when up-to-date memory 
+ * Updates the usage of every region and bank in one pass over the region table.
+ * Should be called periodically or on-demand when up-to-date memory
  * information is required.
  */
 void ramDiagnosticsRefresh(void);
 
+/**
+ * @brief Current end of heap, used end of `.HEAP` region.
+ * @retval Address of first byte after heap
+ */
+uint32_t ramDiagnosticsHeapEnd(void);
+
+/**
+ * @brief Current stack high-water mark, used end of `.STACK` region.
+ * @retval Lowest stack address ever touched
+ */
+uint32_t ramDiagnosticsStackHighWater(void);
+
+/**
+ * @brief Update stack high-water mark.
+ *
+ * Searches the painted stack budget upwards from `_sstack` for the first
+ * word not equal to `STACK_PAINT_PATTERN`. The result is cached and ends
+ * later scans, the mark never moves up, so a rescan costs only the
+ * untouched words and still finds usage below a gap of painted words.
+ *
+ * @retval Peak stack usage in bytes
+ */
+uint32_t ramDiagnosticsStackScan(void);
+
 /**
  * @brief Print general RAM usage information.
  *
- * Displays an overview of all RAM banks, including start/end addresses, 
+ * Displays an overview of all RAM banks, including start/end addresses,
  * total sizes, usage bars, and percentage utilization.
  */
 void ramDiagnosticsGeneral(void);
 
 /**
- * @brief Print detailed RAM1 diagnostics.
+ * @brief Print detailed diagnostics of one bank.
  *
- * Displays section-level information for RAM1, including `.data`, `.bss`, 
- * `.heap`, and `.stack` sizes, usage, and high-water marks.
+ * Displays every region of the bank with start/end addresses, size,
+ * used bytes and utilization. For dynamic regions the end column shows
+ * the current end of the used part (heap end, stack high-water mark).
+ *
+ * @param bank One of MEMINFO_BANK_*
+ */
+void ramDiagnosticsBank(uint8_t bank);
+
+/**
+ * @brief Print detailed RAM1 diagnostics.
  */
 void ramDiagnosticsRAM1(void);
 
 /**
  * @brief Print detailed RAM2 diagnostics.
- *
- * Displays section-level information for RAM2.  
- * By default, this includes `.ramDiagnostics` or any custom sections 
- * assigned to RAM2.
  */
 void ramDiagnosticsRAM2(void);
 
 /**
  * @brief Print detailed CCSRAM diagnostics.
  *
- * Displays section-level information for CCMRAM/CCSRAM.
- * Yes to be implemented
+ * Not applicable in this MCU, see `MEMINFO_BANKS`.
  */
 void ramDiagnosticsCCSRAM(void);
 
@@ -148,4 +235,4 @@ void ramDiagnosticsCCSRAM(void);
     }
 #endif // __cplusplus
 
-#endif // _TRINITYTRACK6000_MEMINFO_H_
\ No newline at end of file
+#endif // _TRINITYTRACK6000_MEMINFO_H_
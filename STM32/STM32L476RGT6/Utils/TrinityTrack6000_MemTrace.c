@@ -0,0 +1,327 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stm32l4xx_hal.h>
+#include <core_cm4.h>
+
+#include <TrinityTrack6000_MemTrace.h>
+#include <TrinityTrack6000_MemInfo.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Format.h>
+#include <TrinityTrack6000_Arena.h>
+
+#if MEMTRACE_ENABLED
+
+#define MEMTRACE_MAGIC           0x7A3C5EEDu // Block allocated and accounted by the wrappers
+#define MEMTRACE_MAGIC_UNTRACKED 0x7A3C5EEEu // Block allocated by the wrappers before memTraceInit()
+#define MEMTRACE_SIZE_MAX        0x00FFFFFFu // Largest size kept in MemTraceHeader
+// newlib chunk in front of every block: size word with 3 flag bits, 4 bytes of overhead while in use,
+// rounded up to 8 bytes, realloc may keep a remainder below the 16 byte minimum chunk
+#define MEMTRACE_CHUNK_FLAGS     0x7u
+#define MEMTRACE_CHUNK_OVERHEAD  4u
+#define MEMTRACE_CHUNK_SLACK     (7u+16u)
+#define MEMTRACE_SITE_OVERFLOW   MEMTRACE_SITES
+#define MEMTRACE_TABLE_WIDTH     56      // Characters of the site table between line start and "\r\n"
+
+// Placed in front of the user data, keeps 8 byte alignment of newlib blocks
+typedef struct{
+	uint32_t magic;
+	uint32_t size:24;
+	uint32_t site:8;
+}MemTraceHeader;
+
+_Static_assert(sizeof(MemTraceHeader)==8,"MemTraceHeader must keep 8 byte alignment of user data");
+_Static_assert(MEMTRACE_SITES<0xFF,"Site index must fit into MemTraceHeader");
+
+extern void*__real_malloc(size_t size);
+extern void __real_free(void*pointer);
+extern void*__real_realloc(void*pointer,size_t size);
+
+extern uint8_t* __sbrk_heap_end; // Defined in sysmem.c
+extern uint32_t _end;
+
+MESSAGE_DEFINE(msg_memTrace_header2,"| Caller     | Allocs | Frees  |  Live [B] |  Peak [B] |\r\n");
+MESSAGE_DEFINE(msg_memTrace_header3,"+------------+--------+--------+-----------+-----------+\r\n");
+                                //  | 0x08001A2B |      3 |      2 |      7600 |     15200 |
+static const char msg_memTrace_formatStringSite[]="| 0x%08lX | %6u | %6u | %9lu | %9lu |\r\n";
+MESSAGE_DEFINE(msg_memTrace_classHeader2,"| Size class | Allocs |\r\n");
+MESSAGE_DEFINE(msg_memTrace_classHeader3,"+------------+--------+\r\n");
+                                //  | <=  8192 B |     12 |
+static const char msg_memTrace_formatStringClass[]="| %s %5lu B | %6lu |\r\n";
+
+MemTraceSite memTrace_sites[MEMTRACE_SITES+1];
+uint32_t memTrace_classes[MEMTRACE_CLASSES];
+uint32_t memTrace_liveBytes;
+uint32_t memTrace_peakBytes;
+uint32_t memTrace_failed;
+uint32_t memTrace_untracked;
+uint32_t memTrace_cyclesLast;
+uint32_t memTrace_cyclesMax;
+
+// Kept in .bss, allocations may happen before memTraceInit() clears RAM2
+static uint8_t memTrace_ready=0;
+
+static void memTraceCycles(uint32_t cycles){
+	memTrace_cyclesLast=cycles;
+	if(cycles>memTrace_cyclesMax){
+		memTrace_cyclesMax=cycles;
+	}
+}
+
+static uint8_t memTraceSizeClass(uint32_t size){
+	uint32_t sizeClass;
+
+	if(size<=8){
+		return 0;
+	}
+	sizeClass=29-__CLZ(size-1); // 9..16 -> 1, 17..32 -> 2 ...
+	return (uint8_t)((sizeClass<MEMTRACE_CLASSES-1)?sizeClass:MEMTRACE_CLASSES-1);
+}
+
+// Open addressing, a call site usually hits its slot on the first probe
+static uint8_t memTraceSite(uint32_t caller){
+	uint32_t index=((caller>>1)^(caller>>7))&(MEMTRACE_SITES-1);
+
+	for(uint8_t probe=0;probe<MEMTRACE_SITES;probe++){
+		if(memTrace_sites[index].caller==caller){
+			return (uint8_t)index;
+		}
+		if(memTrace_sites[index].caller==0){
+			memTrace_sites[index].caller=caller;
+			return (uint8_t)index;
+		}
+		index=(index+1)&(MEMTRACE_SITES-1);
+	}
+	return MEMTRACE_SITE_OVERFLOW;
+}
+
+static void memTraceAllocated(MemTraceHeader*header,uint32_t caller,uint32_t size){
+	MemTraceSite*site;
+
+	header->size=size;
+	if(!memTrace_ready){
+		header->magic=MEMTRACE_MAGIC_UNTRACKED;
+		header->site=MEMTRACE_SITE_OVERFLOW;
+		return;
+	}
+	header->magic=MEMTRACE_MAGIC;
+	header->site=memTraceSite(caller);
+
+	site=&memTrace_sites[header->site];
+	site->allocations++;
+	site->liveBytes+=size;
+	if(site->liveBytes>site->peakBytes){
+		site->peakBytes=site->liveBytes;
+	}
+	memTrace_classes[memTraceSizeClass(size)]++;
+	memTrace_liveBytes+=size;
+	if(memTrace_liveBytes>memTrace_peakBytes){
+		memTrace_peakBytes=memTrace_liveBytes;
+	}
+}
+
+static void memTraceReleased(const MemTraceHeader*header){
+	MemTraceSite*site=&memTrace_sites[header->site];
+
+	site->frees++;
+	site->liveBytes-=header->size;
+	memTrace_liveBytes-=header->size;
+}
+
+// Full magic and a size which fits the newlib chunk around the block, the 8 bytes in front of a
+// pointer which newlib handed out by itself are its chunk header and may hold anything
+static uint8_t memTraceWrapped(const MemTraceHeader*header){
+	uint32_t chunk=((const uint32_t*)header)[-1]&~MEMTRACE_CHUNK_FLAGS;
+	uint32_t used=header->size+sizeof(MemTraceHeader)+MEMTRACE_CHUNK_OVERHEAD;
+
+	if(header->magic!=MEMTRACE_MAGIC&&header->magic!=MEMTRACE_MAGIC_UNTRACKED){
+		return 0;
+	}
+	return chunk>=used&&chunk<=used+MEMTRACE_CHUNK_SLACK;
+}
+
+static void*memTraceMalloc(size_t size,uint32_t caller){
+	uint32_t start=DWT->CYCCNT;
+	uint32_t cycles;
+	MemTraceHeader*header;
+
+	if(size>MEMTRACE_SIZE_MAX){
+		memTrace_failed++;
+		return NULL;
+	}
+	cycles=DWT->CYCCNT-start;
+	header=__real_malloc(size+sizeof(MemTraceHeader));
+	start=DWT->CYCCNT;
+	if(header==NULL){
+		memTrace_failed++;
+		return NULL;
+	}
+	memTraceAllocated(header,caller,(uint32_t)size);
+	memTraceCycles(cycles+DWT->CYCCNT-start);
+
+	return header+1;
+}
+
+void*__wrap_malloc(size_t size){
+	return memTraceMalloc(size,(uint32_t)__builtin_return_address(0));
+}
+
+void __wrap_free(void*pointer){
+	uint32_t start=DWT->CYCCNT;
+	MemTraceHeader*header=(MemTraceHeader*)pointer-1;
+
+	if(pointer==NULL){
+		return;
+	}
+	if(!memTraceWrapped(header)){
+		// Block of newlib internals, not allocated through the wrappers
+		memTrace_untracked++;
+		__real_free(pointer);
+		return;
+	}
+	if(header->magic==MEMTRACE_MAGIC){
+		memTraceReleased(header);
+	}
+	memTraceCycles(DWT->CYCCNT-start);
+	__real_free(header);
+}
+
+void*__wrap_realloc(void*pointer,size_t size){
+	uint32_t caller=(uint32_t)__builtin_return_address(0);
+	MemTraceHeader*header=(MemTraceHeader*)pointer-1;
+	MemTraceHeader previous;
+
+	if(pointer==NULL){
+		return memTraceMalloc(size,caller);
+	}
+	if(size==0){
+		__wrap_free(pointer);
+		return NULL;
+	}
+	if(!memTraceWrapped(header)){
+		memTrace_untracked++;
+		return __real_realloc(pointer,size);
+	}
+	if(size>MEMTRACE_SIZE_MAX){
+		memTrace_failed++;
+		return NULL;
+	}
+	// Old block stays accounted when realloc fails
+	previous=*header;
+	header=__real_realloc(header,size+sizeof(MemTraceHeader));
+	if(header==NULL){
+		memTrace_failed++;
+		return NULL;
+	}
+	if(previous.magic==MEMTRACE_MAGIC){
+		memTraceReleased(&previous);
+	}
+	memTraceAllocated(header,caller,(uint32_t)size);
+
+	return header+1;
+}
+
+void memTraceInit(void){
+	memTrace_ready=0;
+
+	memset(memTrace_sites,0,sizeof(memTrace_sites));
+	memset(memTrace_classes,0,sizeof(memTrace_classes));
+	memTrace_liveBytes=0;
+	memTrace_peakBytes=0;
+	memTrace_failed=0;
+	memTrace_untracked=0;
+	memTrace_cyclesLast=0;
+	memTrace_cyclesMax=0;
+
+	// Bookkeeping cost is measured with the cycle counter
+	CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL|=DWT_CTRL_CYCCNTENA_Msk;
+
+	memTrace_ready=1;
+}
+
+// Sends "+----[ title ]----+" line of the site table
+static void memTraceSendTitle(const char*title){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	uint16_t titleLength=(uint16_t)strlen(title);
+	uint16_t length=0;
+
+	if(buffer==NULL){
+		return;
+	}
+	buffer[length++]='+';
+	length+=formatPad(&buffer[length],'-',(uint8_t)((MEMTRACE_TABLE_WIDTH-2-titleLength)/2));
+	memcpy(&buffer[length],title,titleLength);
+	length+=titleLength;
+	length+=formatPad(&buffer[length],'-',(uint8_t)(MEMTRACE_TABLE_WIDTH-1-length));
+	buffer[length++]='+';
+	buffer[length++]='\r';
+	buffer[length++]='\n';
+
+	uartTxWrite((const uint8_t*)buffer,length);
+	arenaRelease(&arena_scratch,mark);
+}
+
+void memTraceDump(void){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	uint16_t length;
+	uint32_t heapSize=0;
+	uint8_t overhead=0;
+
+	if(buffer==NULL){
+		return;
+	}
+// Send call sites, overflow slot last
+	memTraceSendTitle("[ ALLOCATION SITES ]");
+	uartTxWriteMessage(&msg_memTrace_header2);
+	uartTxWriteMessage(&msg_memTrace_header3);
+	for(uint8_t i=0;i<=MEMTRACE_SITES;i++){
+		const MemTraceSite*site=&memTrace_sites[i];
+
+		if(site->allocations==0){
+			continue;
+		}
+		length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_memTrace_formatStringSite,
+			site->caller,site->allocations,site->frees,site->liveBytes,site->peakBytes);
+		uartTxWrite((const uint8_t*)buffer,length);
+	}
+	uartTxWriteMessage(&msg_memTrace_header3);
+// Send size class histogram
+	uartTxWriteMessage(&msg_memTrace_classHeader2);
+	uartTxWriteMessage(&msg_memTrace_classHeader3);
+	for(uint8_t i=0;i<MEMTRACE_CLASSES;i++){
+		uint8_t last=(i==MEMTRACE_CLASSES-1);
+
+		length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_memTrace_formatStringClass,
+			last?"> ":"<=",8ul<<(last?i-1:i),memTrace_classes[i]);
+		uartTxWrite((const uint8_t*)buffer,length);
+	}
+	uartTxWriteMessage(&msg_memTrace_classHeader3);
+// Send totals, overhead is newlib chunk headers, tracer headers and free chunks
+	if(__sbrk_heap_end!=NULL){
+		heapSize=(uint32_t)__sbrk_heap_end-(uint32_t)&_end;
+	}
+	if(heapSize>memTrace_liveBytes){
+		overhead=(uint8_t)(((heapSize-memTrace_liveBytes)*100)/heapSize);
+	}
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,"| Live %lu B, peak %lu B, heap %lu B, overhead %u%%\r\n",
+		memTrace_liveBytes,memTrace_peakBytes,heapSize,overhead);
+	uartTxWrite((const uint8_t*)buffer,length);
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,"| Failed %lu, untracked %lu, cycles last %lu, max %lu\r\n",
+		memTrace_failed,memTrace_untracked,memTrace_cyclesLast,memTrace_cyclesMax);
+	uartTxWrite((const uint8_t*)buffer,length);
+	uartTxWriteMessage(&msg_memTrace_header3);
+	arenaRelease(&arena_scratch,mark);
+}
+
+#else
+
+MESSAGE_DEFINE(msg_memTrace_disabled,"| Allocation tracer compiled out, configure with -DMEMTRACE=ON\r\n");
+
+void memTraceDump(void){
+	uartTxWriteMessage(&msg_memTrace_disabled);
+}
+
+#endif // MEMTRACE_ENABLED
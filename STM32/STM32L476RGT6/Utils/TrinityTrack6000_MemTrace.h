@@ -0,0 +1,119 @@
+/**
+ * @file TrinityTrack6000_MemTrace.h
+ * @brief Allocation tracer for TrinityTrack6000 project.
+ *
+ * Optional wrappers of newlib `malloc()`, `free()` and `realloc()`, enabled
+ * by the CMake option `MEMTRACE` (`-DMEMTRACE=ON`), which defines
+ * `MEMTRACE_ENABLED` and links with `--wrap=malloc,--wrap=free,--wrap=realloc`.
+ * When the option is off nothing is wrapped, `memTraceInit()` is an empty
+ * inline function and `memTraceDump()` only reports that tracing is compiled out.
+ *
+ * Every traced block carries an 8 byte header in front of the user data
+ * (32 bit magic, call site index and a 24 bit size), so `free()` finds its
+ * call site in O(1) and newlib keeps 8 byte alignment of the user pointer.
+ * A block counts as traced only when the magic matches and the stored size
+ * fits the newlib chunk around it. A double free is not detected, newlib
+ * reuses the header words of a free chunk.
+ * Statistics are kept in RAM2 (`.ramDiagnostics`):
+ * - call sites, `__builtin_return_address(0)` of the caller hashed into
+ *   `MEMTRACE_SITES` slots, with allocation and free counts, live and peak bytes
+ * - size class histogram, class n counts allocations up to `8<<n` bytes
+ * - total live and peak bytes, failed allocations
+ *
+ * Bookkeeping (without newlib itself) is measured with DWT CYCCNT in
+ * `memTrace_cycles*`, it is below 100 cycles while the call site is found
+ * on the first probes. Blocks allocated before `memTraceInit()` and
+ * pointers not allocated through the wrappers (newlib internal `_malloc_r()`)
+ * are passed through without accounting.
+ *
+ * `memTraceDump()` (command `a`) prints the tables with raw caller addresses,
+ * `Scripts/symbolize.py` annotates them with function names from the ELF file.
+ *
+ * @date 2025.09.16
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_MEMTRACE_H_
+    #define _TRINITYTRACK6000_MEMTRACE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <TrinityTrack6000_Config.h>
+#include <TrinityTrack6000_Placement.h>
+
+#ifndef MEMTRACE_ENABLED
+    #define MEMTRACE_ENABLED 0
+#endif
+
+#define MEMTRACE_SITES   32 /**< Call site slots (power of 2), one more slot collects overflow */
+#define MEMTRACE_CLASSES 12 /**< Size classes, up to 8 B ... up to 8 KB, last one is unbounded */
+
+#if (MEMTRACE_SITES&(MEMTRACE_SITES-1))!=0
+    #error "MEMTRACE_SITES must be a power of 2"
+#endif
+
+/**
+ * @brief Statistics of one call site
+ */
+typedef struct{
+    uint32_t caller;     /**< Return address of the allocation call, 0 for overflow slot */
+    uint32_t liveBytes;  /**< Bytes currently allocated by this site */
+    uint32_t peakBytes;  /**< Maximum of liveBytes */
+    uint16_t allocations;/**< Number of allocations */
+    uint16_t frees;      /**< Number of frees of blocks allocated by this site */
+}MemTraceSite;
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+#if MEMTRACE_ENABLED
+
+/**
+ * @brief Allocation tracer statistics, kept in RAM2
+ * @{
+ */
+extern MemTraceSite memTrace_sites[MEMTRACE_SITES+1] RAM2_DIAG(memTrace_sites);      /**< Call sites and overflow slot */
+extern uint32_t memTrace_classes[MEMTRACE_CLASSES]   RAM2_DIAG(memTrace_classes);    /**< Allocations per size class */
+extern uint32_t memTrace_liveBytes                   RAM2_DIAG(memTrace_liveBytes);  /**< Bytes currently allocated */
+extern uint32_t memTrace_peakBytes                   RAM2_DIAG(memTrace_peakBytes);  /**< Maximum of memTrace_liveBytes */
+extern uint32_t memTrace_failed                      RAM2_DIAG(memTrace_failed);     /**< Allocations returning NULL */
+extern uint32_t memTrace_untracked                   RAM2_DIAG(memTrace_untracked);  /**< Frees of blocks without tracer header */
+extern uint32_t memTrace_cyclesLast                  RAM2_DIAG(memTrace_cyclesLast); /**< Bookkeeping cycles of last call */
+extern uint32_t memTrace_cyclesMax                   RAM2_DIAG(memTrace_cyclesMax);  /**< Worst bookkeeping cycles */
+/** @} */
+
+/**
+ * @brief Initialize allocation tracer.
+ *
+ * Resets statistics (already zeroed by startup in `.ramDiagnostics`) and starts accounting.
+ */
+void memTraceInit(void);
+
+/**
+ * @brief Print call site table, size class histogram and heap fragmentation.
+ */
+void memTraceDump(void);
+
+/** @name Linker wrapped allocator entry points
+ *  @{
+ */
+void*__wrap_malloc(size_t size);
+void __wrap_free(void*pointer);
+void*__wrap_realloc(void*pointer,size_t size);
+/** @} */
+
+#else
+
+static inline void memTraceInit(void){
+}
+
+void memTraceDump(void);
+
+#endif // MEMTRACE_ENABLED
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_MEMTRACE_H_
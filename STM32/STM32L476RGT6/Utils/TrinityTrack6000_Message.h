@@ -0,0 +1,40 @@
+/**
+ * @file TrinityTrack6000_Message.h
+ * @brief Constant strings with precomputed lengths for TrinityTrack6000 project.
+ *
+ * Banners, table headers and footers are sent many times per report.
+ * Each message stores a pointer to its text and the length computed by the
+ * compiler with `sizeof`, both placed in flash, so transmit paths never
+ * scan strings with `strlen()` at runtime. `Scripts/message_bench.c` sends
+ * the constant lines of one full memory report both ways on a host and
+ * prints the time saved per report.
+ *
+ * Usage:
+ * - Define message with `MESSAGE_DEFINE(msg_name,"text\r\n");`
+ * - Declare it in a header with `extern const Message msg_name;`
+ * - Send it with `uartTxWriteMessage(&msg_name)`
+ *
+ * @date 2025.09.11
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_MESSAGE_H_
+    #define _TRINITYTRACK6000_MESSAGE_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Constant string with its length
+ */
+typedef struct{
+    const char*text; /**< Message text, NUL terminated */
+    uint16_t length; /**< Number of characters without NUL terminator */
+}Message;
+
+/**
+ * @brief Define a message from a string literal.
+ *
+ * Length is evaluated at compile time, `literal` must be a string literal.
+ */
+#define MESSAGE_DEFINE(name,literal) const Message name={("" literal),(uint16_t)(sizeof(literal)-1)}
+
+#endif // _TRINITYTRACK6000_MESSAGE_H_
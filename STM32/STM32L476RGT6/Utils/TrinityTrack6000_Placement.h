@@ -0,0 +1,53 @@
+/**
+ * @file TrinityTrack6000_Placement.h
+ * @brief Code and data placement attributes for TrinityTrack6000 project.
+ *
+ * SRAM2 (0x10000000) is aliased on the Cortex-M4 I-Code/D-Code buses, so code
+ * copied there runs without flash wait states and without competing with
+ * DMA for SRAM1 on the system bus:
+ * - `RAM2_FUNC` puts a function into `.ram2_text`
+ * - `RAM2_DATA` puts an initialized variable into `.ram2_data`
+ * - `RAM1_FUNC` puts a function into `.RamFunc`, copied with `.data` to SRAM1
+ *
+ * Both RAM2 sections are loaded from flash and copied by `Reset_Handler`
+ * after `SystemInit()`, they form the `.hot` region of `MEMINFO_REGIONS`.
+ * Functions in RAM are out of `BL` range of flash code, `long_call` makes the
+ * compiler load the address instead of relying on linker veneers, so the
+ * attribute belongs on the prototype every caller sees.
+ * `TrinityTrack6000_RamBench.h` measures the same kernel in every placement.
+ *
+ * Variables are placed per variable, the macro takes the variable name and
+ * builds the input section `<output section>.<name>`:
+ * - `RAM2_DATA(name)` initialized variable in `.ram2_data`, copied from flash
+ * - `RAM2_DIAG(name)` diagnostics in `.ramDiagnostics`, zeroed by startup
+ * - `RAM2_SYSDIAG(name)` diagnostics in `.sysDiag`, copied from flash
+ * - `RAM2_LOG(name)` log ring buffers in `.logBuffer`, not initialized
+ * - `RAM2_NOINIT(name)` kept over resets in `.noinit`, not initialized
+ *
+ * With one input section per variable the linker script sorts every RAM
+ * output section by alignment (`SORT_BY_ALIGNMENT`, largest first), so a
+ * `uint8_t` never sits between two words and no fill bytes are needed
+ * whatever the declaration order. Each input section keeps the alignment of
+ * its variable. The same name must be used on the `extern` declaration and
+ * the definition, GCC rejects a definition in another section.
+ * `Scripts/size_report.py` reports the fill saved per output section and
+ * checks the alignment of every input section.
+ *
+ * @date 2025.09.20
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_PLACEMENT_H_
+    #define _TRINITYTRACK6000_PLACEMENT_H_
+
+#define RAM2_FUNC __attribute__((section(".ram2_text"),noinline,long_call)) /**< Function runs from SRAM2 */
+#define RAM1_FUNC __attribute__((section(".RamFunc"),noinline,long_call))   /**< Function runs from SRAM1 */
+
+#define PLACEMENT_SECTION(output,name) __attribute__((section(output "." #name))) /**< Own input section of a variable */
+
+#define RAM2_DATA(name)    PLACEMENT_SECTION(".ram2_data",name)      /**< Initialized variable in SRAM2 */
+#define RAM2_DIAG(name)    PLACEMENT_SECTION(".ramDiagnostics",name) /**< Zeroed diagnostics variable in SRAM2 */
+#define RAM2_SYSDIAG(name) PLACEMENT_SECTION(".sysDiag",name)        /**< Initialized diagnostics variable in SRAM2 */
+#define RAM2_LOG(name)     PLACEMENT_SECTION(".logBuffer",name)      /**< Log buffer in SRAM2, not initialized */
+#define RAM2_NOINIT(name)  PLACEMENT_SECTION(".noinit",name)         /**< Kept over resets in SRAM2, not initialized */
+
+#endif // _TRINITYTRACK6000_PLACEMENT_H_
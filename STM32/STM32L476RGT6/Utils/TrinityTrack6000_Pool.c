@@ -0,0 +1,195 @@
+#include <stdint.h>
+#include <string.h>
+#include <stm32l4xx_hal.h>
+#include <core_cm4.h>
+
+#include <TrinityTrack6000_Pool.h>
+#include <TrinityTrack6000_MemInfo.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Format.h>
+#include <TrinityTrack6000_Arena.h>
+
+// Free block, link is stored in the block itself
+typedef struct PoolBlock{
+	struct PoolBlock*next;
+}PoolBlock;
+
+#define POOL_STORAGE(id,blockSize,blockCount) \
+	_Static_assert((blockSize)%8==0&&(blockSize)>=sizeof(PoolBlock),"Pool " #id " block size must be a multiple of 8"); \
+	static uint8_t pool_storage##id[(blockSize)*(blockCount)] __attribute__((section(".pool"),aligned(8))); \
+	static uint8_t pool_blockUsed##id[(blockCount)];
+#define POOL_ENTRY(id,blockSize,blockCount) {pool_storage##id,pool_storage##id+sizeof(pool_storage##id),pool_blockUsed##id,(blockSize),(blockCount)},
+
+POOL_CLASSES(POOL_STORAGE)
+
+const Pool pool_pools[POOL_COUNT]={
+	POOL_CLASSES(POOL_ENTRY)
+};
+
+extern uint32_t __POOL_START__;
+
+MESSAGE_DEFINE(msg_pool_header1,"+----------------------[ POOLS ]-----------------------+\r\n");
+MESSAGE_DEFINE(msg_pool_header2,"| Block [B] | Blocks | Used   | Peak   | Failed | Free |\r\n");
+MESSAGE_DEFINE(msg_pool_header3,"+-----------+--------+--------+--------+--------+------+\r\n");
+                            //  |      7680 |      1 |      1 |      1 |      0 |   0% |
+static const char msg_pool_formatStringPool[]="| %9u | %6u | %6u | %6u | %6u | %3u%% |\r\n";
+
+uint16_t pool_used[POOL_COUNT];
+uint16_t pool_peak[POOL_COUNT];
+uint16_t pool_failed[POOL_COUNT];
+uint32_t pool_usedBytes;
+uint32_t pool_allocCyclesLast;
+uint32_t pool_allocCyclesMax;
+uint32_t pool_freeCyclesLast;
+uint32_t pool_freeCyclesMax;
+uint32_t pool_invalidFrees;
+
+static PoolBlock*pool_free[POOL_COUNT];
+
+void poolInit(void){
+	for(uint8_t i=0;i<POOL_COUNT;i++){
+		const Pool*pool=&pool_pools[i];
+		PoolBlock*next=NULL;
+
+		// Linked from the end, so blocks are handed out in address order
+		for(uint16_t n=pool->blockCount;n>0;n--){
+			PoolBlock*block=(PoolBlock*)(pool->start+(uint32_t)(n-1)*pool->blockSize);
+
+			block->next=next;
+			next=block;
+		}
+		pool_free[i]=next;
+		memset(pool->used,0,pool->blockCount);
+	}
+	memset(pool_used,0,sizeof(pool_used));
+	memset(pool_peak,0,sizeof(pool_peak));
+	memset(pool_failed,0,sizeof(pool_failed));
+	pool_usedBytes=0;
+	pool_allocCyclesLast=0;
+	pool_allocCyclesMax=0;
+	pool_freeCyclesLast=0;
+	pool_freeCyclesMax=0;
+	pool_invalidFrees=0;
+
+	// Latency is measured with the cycle counter
+	CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL|=DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void*poolAlloc(uint32_t size){
+	uint32_t start=DWT->CYCCNT;
+	uint32_t primask;
+	PoolBlock*block;
+	uint8_t i=0;
+
+	while(i<POOL_COUNT&&pool_pools[i].blockSize<size){
+		i++;
+	}
+	if(i==POOL_COUNT){
+		return NULL;
+	}
+
+	primask=__get_PRIMASK();
+	__disable_irq();
+	block=pool_free[i];
+	if(block!=NULL){
+		pool_free[i]=block->next;
+		pool_pools[i].used[((uint8_t*)block-pool_pools[i].start)/pool_pools[i].blockSize]=1;
+		pool_usedBytes+=pool_pools[i].blockSize;
+		if(++pool_used[i]>pool_peak[i]){
+			pool_peak[i]=pool_used[i];
+		}
+	}
+	else{
+		pool_failed[i]++;
+	}
+	__set_PRIMASK(primask);
+
+	pool_allocCyclesLast=DWT->CYCCNT-start;
+	if(pool_allocCyclesLast>pool_allocCyclesMax){
+		pool_allocCyclesMax=pool_allocCyclesLast;
+	}
+	return block;
+}
+
+void poolFree(void*block){
+	uint32_t start=DWT->CYCCNT;
+	uint32_t primask;
+	uint32_t offset;
+	uint8_t*used;
+	uint8_t i=0;
+
+	if(block==NULL){
+		return;
+	}
+	while(i<POOL_COUNT&&((uint8_t*)block<pool_pools[i].start||(uint8_t*)block>=pool_pools[i].end)){
+		i++;
+	}
+	if(i==POOL_COUNT){
+		pool_invalidFrees++; // Not a pool block
+		return;
+	}
+	offset=(uint32_t)((uint8_t*)block-pool_pools[i].start);
+	if(offset%pool_pools[i].blockSize!=0){
+		pool_invalidFrees++; // Inside a block
+		return;
+	}
+	used=&pool_pools[i].used[offset/pool_pools[i].blockSize];
+
+	primask=__get_PRIMASK();
+	__disable_irq();
+	if(*used==0){
+		__set_PRIMASK(primask);
+		pool_invalidFrees++; // Double free, linking it again would hand the block out twice
+		return;
+	}
+	*used=0;
+	((PoolBlock*)block)->next=pool_free[i];
+	pool_free[i]=(PoolBlock*)block;
+	pool_usedBytes-=pool_pools[i].blockSize;
+	pool_used[i]--;
+	__set_PRIMASK(primask);
+
+	pool_freeCyclesLast=DWT->CYCCNT-start;
+	if(pool_freeCyclesLast>pool_freeCyclesMax){
+		pool_freeCyclesMax=pool_freeCyclesLast;
+	}
+}
+
+uint32_t poolUsedEnd(void){
+	return (uint32_t)&__POOL_START__+pool_usedBytes;
+}
+
+void poolReport(void){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	uint16_t length;
+
+	if(buffer==NULL){
+		return;
+	}
+	uartTxWriteMessage(&msg_pool_header1);
+	uartTxWriteMessage(&msg_pool_header2);
+	uartTxWriteMessage(&msg_pool_header3);
+	for(uint8_t i=0;i<POOL_COUNT;i++){
+		const Pool*pool=&pool_pools[i];
+
+		length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_pool_formatStringPool,
+			pool->blockSize,                                               // Block size
+			pool->blockCount,                                              // Number of blocks
+			pool_used[i],                                                  // Blocks in use
+			pool_peak[i],                                                  // Peak blocks in use
+			pool_failed[i],                                                // Refused allocations
+			(unsigned)((pool->blockCount-pool_used[i])*100/pool->blockCount) // Free blocks percent
+		);
+		uartTxWrite((const uint8_t*)buffer,length);
+	}
+	uartTxWriteMessage(&msg_pool_header3);
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,"| Alloc cycles last %lu, max %lu, free last %lu, max %lu\r\n",
+		pool_allocCyclesLast,pool_allocCyclesMax,pool_freeCyclesLast,pool_freeCyclesMax);
+	uartTxWrite((const uint8_t*)buffer,length);
+	length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,"| Invalid frees %lu\r\n",pool_invalidFrees);
+	uartTxWrite((const uint8_t*)buffer,length);
+	uartTxWriteMessage(&msg_pool_header3);
+	arenaRelease(&arena_scratch,mark);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file TrinityTrack6000_Pool.h
+ * @brief Fixed-block pool allocator for TrinityTrack6000 project.
+ *
+ * Static replacement of newlib `malloc()`. Block sizes and counts are fixed
+ * at compile time by `POOL_CLASSES` in TrinityTrack6000_Config.h, storage of
+ * all pools is carved from the `.pool` linker section in RAM1.
+ *
+ * Every pool keeps an intrusive singly linked free list, the link is stored
+ * in the first word of a free block, so:
+ * - `poolAlloc()` takes the smallest class fitting the request and pops
+ *   its free list head, there is no fallback to larger classes, so the
+ *   result does not depend on the history of other classes
+ * - `poolFree()` finds the pool by address range and pushes the block back,
+ *   a pointer outside the pools, inside a block or to a block already free
+ *   (per block used flag) is rejected and counted in `pool_invalidFrees`
+ * Both run in constant time (a bounded loop over the classes and a short
+ * critical section), their cost is measured with DWT CYCCNT in `pool_*Cycles*`.
+ *
+ * Usage of every pool (blocks in use, peak, failed allocations) is kept in
+ * the `.ramDiagnostics` section in RAM2, the whole `.pool` section is the
+ * `.POOL` region of `MEMINFO_REGIONS`.
+ *
+ * With `NEWLIB_HEAP_ENABLED` 0 (CMake option `NEWLIB_HEAP` off) the linker
+ * script asserts that `_sbrk()` was removed by `--gc-sections`, so any code
+ * pulling in newlib `malloc()` (including stdio buffering) fails the link.
+ *
+ * @date 2025.09.17
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_POOL_H_
+    #define _TRINITYTRACK6000_POOL_H_
+
+#include <stdint.h>
+
+#include <TrinityTrack6000_Config.h>
+#include <TrinityTrack6000_Placement.h>
+
+#define POOL_ID(id,blockSize,blockCount) POOL_##id,
+
+enum{
+    POOL_CLASSES(POOL_ID)
+    POOL_COUNT
+};
+
+/**
+ * @brief Pool descriptor, in flash
+ */
+typedef struct{
+    uint8_t*start;       /**< First block */
+    uint8_t*end;         /**< First byte after last block */
+    uint8_t*used;        /**< One flag per block, 1 while allocated */
+    uint16_t blockSize;  /**< Size of every block in bytes */
+    uint16_t blockCount; /**< Number of blocks */
+}Pool;
+
+extern const Pool pool_pools[POOL_COUNT]; /**< Pool table, ordered by block size */
+
+/**
+ * @brief Pool statistics, kept in RAM2
+ * @{
+ */
+extern uint16_t pool_used[POOL_COUNT]   RAM2_DIAG(pool_used);            /**< Blocks in use */
+extern uint16_t pool_peak[POOL_COUNT]   RAM2_DIAG(pool_peak);            /**< Maximum of pool_used */
+extern uint16_t pool_failed[POOL_COUNT] RAM2_DIAG(pool_failed);          /**< Allocations refused, pool empty */
+extern uint32_t pool_usedBytes          RAM2_DIAG(pool_usedBytes);       /**< Bytes of blocks in use, all pools */
+extern uint32_t pool_allocCyclesLast    RAM2_DIAG(pool_allocCyclesLast); /**< Cycles of last poolAlloc() */
+extern uint32_t pool_allocCyclesMax     RAM2_DIAG(pool_allocCyclesMax);  /**< Worst poolAlloc() cycles */
+extern uint32_t pool_freeCyclesLast     RAM2_DIAG(pool_freeCyclesLast);  /**< Cycles of last poolFree() */
+extern uint32_t pool_freeCyclesMax      RAM2_DIAG(pool_freeCyclesMax);   /**< Worst poolFree() cycles */
+extern uint32_t pool_invalidFrees       RAM2_DIAG(pool_invalidFrees);    /**< poolFree() calls rejected, not a block or already free */
+/** @} */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Initialize pools.
+ *
+ * Links all blocks into free lists and clears statistics. This is the only
+ * place where time depends on the number of blocks.
+ */
+void poolInit(void);
+
+/**
+ * @brief Allocate a block.
+ * @param size Requested size in bytes
+ * @retval Block of the smallest fitting class, 8 byte aligned, or NULL when the class is empty or size too large
+ */
+void*poolAlloc(uint32_t size);
+
+/**
+ * @brief Return a block to its pool.
+ *
+ * Anything but an allocated block is ignored and counted in `pool_invalidFrees`.
+ * @param block Block returned by `poolAlloc()` or NULL
+ */
+void poolFree(void*block);
+
+/**
+ * @brief End of used part of `.POOL` region, start plus bytes in use.
+ * @retval Address used by MemInfo to compute region usage
+ */
+uint32_t poolUsedEnd(void);
+
+/**
+ * @brief Print usage of every pool.
+ */
+void poolReport(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_POOL_H_
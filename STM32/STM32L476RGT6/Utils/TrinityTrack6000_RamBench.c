@@ -0,0 +1,125 @@
+#include <stdint.h>
+#include <stm32l4xx_hal.h>
+#include <core_cm4.h>
+
+#include <TrinityTrack6000_RamBench.h>
+#include <TrinityTrack6000_Placement.h>
+#include <TrinityTrack6000_MemInfo.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Format.h>
+
+#define RAMBENCH_FLASH_FUNC __attribute__((noinline))
+
+// One body for every placement, noclone keeps constant propagated copies out of .text
+#define RAMBENCH_KERNEL(name,placement) \
+	static placement __attribute__((noclone)) uint16_t name(const uint8_t*data,uint16_t length){ \
+		uint16_t crc=0xFFFF; \
+		while(length--){ \
+			crc^=(uint16_t)(*data++<<8); \
+			for(uint8_t bit=0;bit<8;bit++){ \
+				crc=(crc&0x8000)?(uint16_t)((crc<<1)^0x1021):(uint16_t)(crc<<1); \
+			} \
+		} \
+		return crc; \
+	}
+
+RAMBENCH_KERNEL(ramBenchKernelFlash,RAMBENCH_FLASH_FUNC)
+RAMBENCH_KERNEL(ramBenchKernelRam1,RAM1_FUNC)
+RAMBENCH_KERNEL(ramBenchKernelRam2,RAM2_FUNC)
+
+typedef uint16_t(*RamBenchKernel)(const uint8_t*data,uint16_t length);
+
+typedef struct{
+	const char*code;
+	const char*data;
+	RamBenchKernel kernel;
+	const uint8_t*input;
+}RamBenchCase;
+
+static uint8_t ramBench_inputRam1[RAMBENCH_LENGTH];
+static uint8_t ramBench_inputRam2[RAMBENCH_LENGTH] RAM2_DIAG(ramBench_inputRam2); // NOLOAD, filled by ramBenchRun()
+
+static const RamBenchCase ramBench_cases[]={
+	{"FLASH+ART","SRAM1",ramBenchKernelFlash,ramBench_inputRam1},
+	{"SRAM1",    "SRAM1",ramBenchKernelRam1, ramBench_inputRam1},
+	{"SRAM2",    "SRAM1",ramBenchKernelRam2, ramBench_inputRam1},
+	{"SRAM2",    "SRAM2",ramBenchKernelRam2, ramBench_inputRam2}
+};
+
+static volatile uint16_t ramBench_sink; // Keeps results alive
+
+MESSAGE_DEFINE(msg_ramBench_header1,"+-----------------[ CODE PLACEMENT ]-------------------+\r\n");
+MESSAGE_DEFINE(msg_ramBench_header2,"| Code      | Data  | Cold [cyc] | Warm [cyc] | cyc/B  |\r\n");
+MESSAGE_DEFINE(msg_ramBench_header3,"+-----------+-------+------------+------------+--------+\r\n");
+                                 //  | FLASH+ART | SRAM1 |      41234 |      40960 | 160.00 |
+static const char msg_ramBench_formatStringCase[]="| %-9s | %-5s | %10lu | %10lu | %3lu.%02lu |\r\n";
+
+static uint32_t ramBenchMeasure(const RamBenchCase*test){
+	uint32_t primask=__get_PRIMASK();
+	uint32_t start;
+	uint32_t cycles;
+
+	__disable_irq();
+	start=DWT->CYCCNT;
+	ramBench_sink=test->kernel(test->input,RAMBENCH_LENGTH);
+	cycles=DWT->CYCCNT-start;
+	__set_PRIMASK(primask);
+
+	return cycles;
+}
+
+static void ramBenchResetArt(void){
+	__HAL_FLASH_INSTRUCTION_CACHE_DISABLE();
+	__HAL_FLASH_DATA_CACHE_DISABLE();
+	__HAL_FLASH_INSTRUCTION_CACHE_RESET();
+	__HAL_FLASH_DATA_CACHE_RESET();
+	__HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+	__HAL_FLASH_DATA_CACHE_ENABLE();
+}
+
+void ramBenchRun(void){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1);
+	uint16_t length;
+
+	if(buffer==NULL){
+		return;
+	}
+	CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL|=DWT_CTRL_CYCCNTENA_Msk;
+
+	for(uint16_t i=0;i<RAMBENCH_LENGTH;i++){
+		ramBench_inputRam1[i]=(uint8_t)(i*37+11);
+		ramBench_inputRam2[i]=ramBench_inputRam1[i];
+	}
+
+	uartTxWriteMessage(&msg_ramBench_header1);
+	uartTxWriteMessage(&msg_ramBench_header2);
+	uartTxWriteMessage(&msg_ramBench_header3);
+	for(uint8_t i=0;i<sizeof(ramBench_cases)/sizeof(ramBench_cases[0]);i++){
+		const RamBenchCase*test=&ramBench_cases[i];
+		uint32_t cold;
+		uint32_t warm=UINT32_MAX;
+
+		ramBenchResetArt();
+		cold=ramBenchMeasure(test);
+		for(uint8_t run=0;run<RAMBENCH_RUNS;run++){
+			uint32_t cycles=ramBenchMeasure(test);
+
+			if(cycles<warm){
+				warm=cycles;
+			}
+		}
+		length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_ramBench_formatStringCase,
+			test->code,                                  // Code placement
+			test->data,                                  // Input placement
+			cold,                                        // First run after ART reset
+			warm,                                        // Best of RAMBENCH_RUNS
+			warm/RAMBENCH_LENGTH,                        // Cycles per byte, integer part
+			(warm%RAMBENCH_LENGTH)*100/RAMBENCH_LENGTH   // Cycles per byte, hundredths
+		);
+		uartTxWrite((const uint8_t*)buffer,length);
+	}
+	uartTxWriteMessage(&msg_ramBench_header3);
+	arenaRelease(&arena_scratch,mark);
+}
@@ -0,0 +1,43 @@
+/**
+ * @file TrinityTrack6000_RamBench.h
+ * @brief Code placement benchmark for TrinityTrack6000 project.
+ *
+ * The same kernel (bitwise CRC-16/CCITT-FALSE over `RAMBENCH_LENGTH` bytes,
+ * a tight loop with a data dependent branch) is compiled once per placement
+ * from one macro body:
+ * - flash through the ART accelerator (instruction and data cache)
+ * - SRAM1 (`RAM1_FUNC`), fetched over the system bus together with the data
+ * - SRAM2 (`RAM2_FUNC`), fetched over I-Code, data in SRAM1 or in SRAM2
+ *
+ * Every variant is timed with DWT CYCCNT and interrupts masked. The cold run
+ * follows an ART cache reset, the warm value is the minimum of
+ * `RAMBENCH_RUNS` runs. Results are printed as cycles and cycles per byte.
+ *
+ * @date 2025.09.20
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_RAMBENCH_H_
+    #define _TRINITYTRACK6000_RAMBENCH_H_
+
+#include <stdint.h>
+
+#define RAMBENCH_LENGTH 256 /**< Kernel input size in bytes */
+#define RAMBENCH_RUNS   8   /**< Warm runs per placement */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Run the kernel in every placement and print the table.
+ *
+ * Takes a few hundred thousand cycles with interrupts masked per run,
+ * meant for boot time.
+ */
+void ramBenchRun(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_RAMBENCH_H_
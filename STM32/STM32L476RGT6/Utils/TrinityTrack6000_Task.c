@@ -0,0 +1,197 @@
+#include <stdint.h>
+#include <string.h>
+#include <stm32l4xx_hal.h>
+#include <core_cm4.h>
+
+#include <main.h>
+#include <TrinityTrack6000_Task.h>
+#include <TrinityTrack6000_MemInfo.h>
+#include <TrinityTrack6000_Arena.h>
+#include <TrinityTrack6000_Errors.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Format.h>
+#include <TrinityTrack6000_Commands.h>
+#include <TrinityTrack6000_Telemetry.h>
+#include <TrinityTrack6000_Log.h>
+#include <TrinityTrack6000_Crash.h>
+
+#define TASK_ENTRY(id,entry,stackSize,placement) \
+	{#id,entry,&task_frame_##id.tcb,task_frame_##id.guard,task_frame_##id.stack,(stackSize),TASK_FLAGS_##placement},
+
+TASKS(TASK_FRAME)
+
+const Task task_tasks[TASK_COUNT]={
+	TASKS(TASK_ENTRY)
+};
+
+volatile uint8_t task_running=TASK_NONE;
+
+uint32_t task_faultTask;
+uint32_t task_faultAddress;
+uint32_t task_faultStatus;
+
+MESSAGE_DEFINE(msg_task_header1,"+----------------------[ TASKS ]-----------------------+\r\n");
+MESSAGE_DEFINE(msg_task_header2,"| Task      | Bank | Stack | Used  | Runs    | Max cyc |\r\n");
+MESSAGE_DEFINE(msg_task_header3,"+-----------+------+-------+-------+---------+---------+\r\n");
+                            //  | telemetry | RAM2 |   512 |   184 | 1234567 |    4200 |
+static const char msg_task_formatStringTask[]="| %-9s | %-4s | %5u | %5lu | %7lu | %7lu |\r\n";
+
+// Calls entry with the thread stack pointer switched to PSP at top, back on MSP afterwards
+__attribute__((naked)) static void taskCall(void(*entry)(void),uint32_t top){
+	__asm volatile(
+		"push {r4, lr}      \n" // On MSP, keeps it 8 byte aligned
+		"msr psp, r1        \n"
+		"mrs r4, control    \n"
+		"orr r4, r4, #2     \n" // SPSEL, thread mode uses PSP
+		"msr control, r4    \n"
+		"isb                \n"
+		"blx r0             \n"
+		"mrs r4, control    \n"
+		"bic r4, r4, #2     \n"
+		"msr control, r4    \n"
+		"isb                \n"
+		"pop {r4, pc}       \n"
+	);
+}
+
+void taskInit(void){
+	for(uint8_t id=0;id<TASK_COUNT;id++){
+		const Task*task=&task_tasks[id];
+
+		memset(task->tcb,0,sizeof(TaskControlBlock));
+		if(crash_warmBoot){ // Frames survive the reset, painted by the cold boot
+			continue;
+		}
+		for(uint8_t i=0;i<TASK_GUARD_SIZE/sizeof(uint32_t);i++){
+			task->guard[i]=TASK_GUARD_PATTERN;
+		}
+		for(uint16_t i=0;i<task->stackSize/sizeof(uint32_t);i++){
+			task->stack[i]=STACK_PAINT_PATTERN;
+		}
+	}
+
+	// Guard region, moved to the running task by taskRun()
+	MPU_Region_InitTypeDef region={0};
+
+	HAL_MPU_Disable();
+	region.Enable=MPU_REGION_ENABLE;
+	region.Number=TASK_MPU_REGION;
+	region.BaseAddress=(uint32_t)task_tasks[0].guard;
+	region.Size=MPU_REGION_SIZE_32B;
+	region.SubRegionDisable=0x00;
+	region.TypeExtField=MPU_TEX_LEVEL0;
+	region.AccessPermission=MPU_REGION_NO_ACCESS;
+	region.DisableExec=MPU_INSTRUCTION_ACCESS_DISABLE;
+	region.IsShareable=MPU_ACCESS_NOT_SHAREABLE;
+	region.IsCacheable=MPU_ACCESS_NOT_CACHEABLE;
+	region.IsBufferable=MPU_ACCESS_NOT_BUFFERABLE;
+	HAL_MPU_ConfigRegion(&region);
+	HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT); // Also enables MemManage fault
+
+	task_faultTask=TASK_NONE;
+	task_faultAddress=0;
+	task_faultStatus=0;
+
+	// Run time is measured with the cycle counter
+	CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL|=DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void taskRun(uint8_t id){
+	const Task*task=&task_tasks[id];
+	TaskControlBlock*tcb=task->tcb;
+	uint32_t start=DWT->CYCCNT;
+
+	// Same size and attributes for every guard, only the base moves
+	MPU->RBAR=(uint32_t)task->guard|MPU_RBAR_VALID_Msk|TASK_MPU_REGION;
+	__DSB();
+	task_running=id;
+
+	taskCall(task->entry,(uint32_t)task->stack+task->stackSize);
+
+	task_running=TASK_NONE;
+	tcb->cyclesLast=DWT->CYCCNT-start;
+	if(tcb->cyclesLast>tcb->cyclesMax){
+		tcb->cyclesMax=tcb->cyclesLast;
+	}
+	tcb->runs++;
+}
+
+uint8_t taskFaultOverflow(void){
+	uint32_t status=SCB->CFSR&SCB_CFSR_MEMFAULTSR_Msk;
+
+	if(status&SCB_CFSR_MMARVALID_Msk){
+		uint32_t address=SCB->MMFAR;
+
+		for(uint8_t i=0;i<TASK_COUNT;i++){
+			if(address-(uint32_t)task_tasks[i].guard<TASK_GUARD_SIZE){
+				return i;
+			}
+		}
+		return TASK_NONE;
+	}
+	// Stacking into the guard on exception entry leaves no address
+	if(status&SCB_CFSR_MSTKERR_Msk){
+		return task_running;
+	}
+	return TASK_NONE;
+}
+
+void taskFault(void){
+	uint32_t status=SCB->CFSR&SCB_CFSR_MEMFAULTSR_Msk;
+	uint8_t id=taskFaultOverflow();
+
+	task_faultAddress=(status&SCB_CFSR_MMARVALID_Msk)?SCB->MMFAR:0;
+	task_faultStatus=status; // CFSR is left set for the crash record
+	if(id!=TASK_NONE){
+		task_faultTask=id;
+		global_error_code=ERROR_TASK_STACK_OVERFLOW+id;
+	}
+	else{
+		// XN, IACCVIOL or an access outside the guards, not a stack overflow
+		task_faultTask=task_running;
+		global_error_code=ERROR_MEM_MANAGE;
+	}
+	Error_Handler();
+}
+
+uint32_t taskStackScan(uint8_t id){
+	const Task*task=&task_tasks[id];
+	const uint32_t*word=task->stack;
+	const uint32_t*top=task->stack+task->stackSize/sizeof(uint32_t);
+
+	while(word<top&&*word==STACK_PAINT_PATTERN){
+		word++;
+	}
+	task->tcb->stackUsed=(uint32_t)top-(uint32_t)word;
+
+	return task->tcb->stackUsed;
+}
+
+void taskReport(void){
+	uint32_t mark=arenaMark(&arena_scratch);
+	char*buffer=arenaAlloc(&arena_scratch,MEMINFO_LINE_BUFFER_SIZE,1); // Runs on the commands task stack
+	uint16_t length;
+
+	if(buffer==NULL){
+		return;
+	}
+	uartTxWriteMessage(&msg_task_header1);
+	uartTxWriteMessage(&msg_task_header2);
+	uartTxWriteMessage(&msg_task_header3);
+	for(uint8_t id=0;id<TASK_COUNT;id++){
+		const Task*task=&task_tasks[id];
+
+		length=formatString(buffer,MEMINFO_LINE_BUFFER_SIZE,msg_task_formatStringTask,
+			task->name,                                                                                  // Task name
+			ramDiagnostics_banks[(task->flags&TASK_FLAG_HOT)?MEMINFO_BANK_RAM2:MEMINFO_BANK_RAM1].name, // Bank of frame
+			task->stackSize,                                                                             // Stack size
+			taskStackScan(id),                                                                           // Stack high-water mark
+			task->tcb->runs,                                                                             // Completed runs
+			task->tcb->cyclesMax                                                                         // Worst run cycles
+		);
+		uartTxWrite((const uint8_t*)buffer,length);
+	}
+	uartTxWriteMessage(&msg_task_header3);
+	arenaRelease(&arena_scratch,mark);
+}
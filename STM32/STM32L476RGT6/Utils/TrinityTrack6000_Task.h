@@ -0,0 +1,193 @@
+/**
+ * @file TrinityTrack6000_Task.h
+ * @brief Task frames (guard zone, stack, TCB) in linker sections for TrinityTrack6000 project.
+ *
+ * Every job of the main loop runs as a task on its own stack, so its stack
+ * usage is measured separately and an overflow is caught before it reaches
+ * other data. Tasks are declared by `TASKS` in TrinityTrack6000_Config.h,
+ * `TASK_FRAME()` defines one contiguous frame per task:
+ *
+ *     low address   guard zone   TASK_GUARD_SIZE bytes of TASK_GUARD_PATTERN
+ *                   stack        stackSize bytes, grows down towards the guard
+ *     high address  TCB          TaskControlBlock, run statistics
+ *
+ * Frames are aligned to `TASK_GUARD_SIZE` (the smallest MPU region) and
+ * stack sizes are multiples of it, so every guard zone can become an MPU
+ * region. The placement of a task selects the output section at build time:
+ * - `HOT` tasks go to `.crit` in RAM2, which the core reaches over its own
+ *   D-bus, away from the DMA traffic on SRAM1
+ * - `COLD` tasks go to `.tdat` in RAM1
+ * Both sections are NOLOAD and form the `.TDAT` and `.crit` regions of
+ * `MEMINFO_REGIONS`.
+ *
+ * `taskRun()` switches the thread stack pointer to the task stack (PSP),
+ * calls the entry and switches back to MSP. Interrupts stack their frame on
+ * the task stack, so the stack size must cover it (up to 104 bytes with
+ * FPU context).
+ *
+ * Guard zones are enforced by the MPU, nothing polls them. `taskInit()`
+ * configures `TASK_MPU_REGION` (32 bytes, no access, not executable) through
+ * HAL_MPU_ConfigRegion() with the default memory map as background, and
+ * `taskRun()` moves the region to the guard of the task it switches to,
+ * a single RBAR store (size and attributes are the same for every guard).
+ * The first access into the guard raises MemManage, `taskFault()` records
+ * the task, fault address and status in `.sysDiag` and ends in
+ * `Error_Handler()` with `ERROR_TASK_STACK_OVERFLOW` plus the task id in
+ * `global_error_code`. An overflow during exception entry (MSTKERR) has
+ * no valid address, the running task is recorded. Every other MemManage
+ * fault (XN, IACCVIOL, an address outside the guards, MSTKERR outside of
+ * tasks) ends with `ERROR_MEM_MANAGE`. A frame larger than the guard which
+ * skips over it is not detected.
+ *
+ * Only core registers (SCB, MPU) are used, so the scheme can be checked
+ * under QEMU's M-profile MPU emulation with a Cortex-M4 machine, e.g.
+ * `qemu-system-arm -M mps2-an386 -kernel <elf> -S -s` and gdb: call
+ * `taskInit()`, set `task_running` and RBAR to a task, then write to its
+ * `guard`, `task_faultTask` must hold the task id after MemManage.
+ *
+ * @date 2025.09.19
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_TASK_H_
+    #define _TRINITYTRACK6000_TASK_H_
+
+#include <stdint.h>
+
+#include <TrinityTrack6000_Config.h>
+#include <TrinityTrack6000_Placement.h>
+
+#define TASK_GUARD_SIZE    32          /**< Guard zone size in bytes, smallest MPU region */
+#define TASK_GUARD_PATTERN 0x3C3C3C3Cu /**< Content of an intact guard zone */
+
+#define TASK_FLAG_HOT 0x01 /**< Frame is in `.crit` (RAM2) */
+
+#define TASK_MPU_REGION 0    /**< MPU region reprogrammed on every task switch */
+#define TASK_NONE       0xFF /**< `task_running` value outside of tasks */
+
+/** @name Task placements, last argument of `TASKS`
+ *  @{
+ */
+#define TASK_SECTION_HOT  ".crit"
+#define TASK_SECTION_COLD ".tdat"
+#define TASK_FLAGS_HOT    TASK_FLAG_HOT
+#define TASK_FLAGS_COLD   0
+/** @} */
+
+/**
+ * @brief Task control block, at the top of the task frame
+ */
+typedef struct{
+    uint32_t runs;       /**< Completed runs */
+    uint32_t cyclesLast; /**< Cycles of last run */
+    uint32_t cyclesMax;  /**< Worst run cycles */
+    uint32_t stackUsed;  /**< Stack high-water mark in bytes, updated by `taskStackScan()` */
+}TaskControlBlock;
+
+/**
+ * @brief Task descriptor, in flash
+ */
+typedef struct{
+    const char*name;       /**< Task name */
+    void(*entry)(void);    /**< Function run by `taskRun()` */
+    TaskControlBlock*tcb;  /**< Control block */
+    uint32_t*guard;        /**< Guard zone, TASK_GUARD_SIZE bytes */
+    uint32_t*stack;        /**< Lowest stack word, first above the guard */
+    uint16_t stackSize;    /**< Stack size in bytes */
+    uint8_t flags;         /**< TASK_FLAG_* */
+}Task;
+
+/**
+ * @brief Define the frame of one task in the section of its placement.
+ *
+ * Expands to a static object `task_frame_<id>` in section `.crit.<id>` or
+ * `.tdat.<id>`. Used by TrinityTrack6000_Task.c on every `TASKS` entry.
+ */
+#define TASK_FRAME(id,entry,stackSize,placement) \
+    _Static_assert((stackSize)%TASK_GUARD_SIZE==0,"Stack of task " #id " must be a multiple of TASK_GUARD_SIZE"); \
+    static struct{ \
+        uint32_t guard[TASK_GUARD_SIZE/sizeof(uint32_t)]; \
+        uint32_t stack[(stackSize)/sizeof(uint32_t)]; \
+        TaskControlBlock tcb; \
+    }task_frame_##id __attribute__((section(TASK_SECTION_##placement "." #id),aligned(TASK_GUARD_SIZE)));
+
+#define TASK_ID(id,entry,stackSize,placement) TASK_##id,
+
+enum{
+    TASKS(TASK_ID)
+    TASK_COUNT
+};
+
+extern const Task task_tasks[TASK_COUNT]; /**< Task table, in `TASKS` order */
+
+extern volatile uint8_t task_running; /**< Id of the running task or TASK_NONE */
+
+/**
+ * @brief Last guard zone violation, kept in RAM2
+ * @{
+ */
+extern uint32_t task_faultTask    RAM2_SYSDIAG(task_faultTask);    /**< Overflowed task, or running task (TASK_NONE) of any other MemManage */
+extern uint32_t task_faultAddress RAM2_SYSDIAG(task_faultAddress); /**< MMFAR, 0 when not valid */
+extern uint32_t task_faultStatus  RAM2_SYSDIAG(task_faultStatus);  /**< MemManage fault status (MMFSR) */
+/** @} */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Initialize task frames.
+ *
+ * Fills guard zones with `TASK_GUARD_PATTERN`, paints stacks with
+ * `STACK_PAINT_PATTERN`, clears control blocks (the sections are NOLOAD)
+ * and enables the MPU with the guard region. A warm boot keeps the guards
+ * and stacks of the crashed run, see TrinityTrack6000_Crash.h.
+ */
+void taskInit(void);
+
+/**
+ * @brief Run a task on its own stack with its guard zone protected.
+ *
+ * Must be called from thread mode running on MSP (main loop).
+ *
+ * @param id Task id, TASK_<id>
+ */
+void taskRun(uint8_t id);
+
+/**
+ * @brief Task whose stack overflowed into its guard.
+ *
+ * The task is found by MMFAR inside a guard, or is the running task on
+ * MSTKERR (no valid address).
+ * @retval Task id, TASK_NONE when the MemManage fault is not a stack overflow
+ */
+uint8_t taskFaultOverflow(void);
+
+/**
+ * @brief Record a MemManage fault, called by `MemManage_Handler()`.
+ *
+ * A stack overflow sets `ERROR_TASK_STACK_OVERFLOW` plus the task id, any
+ * other MemManage fault `ERROR_MEM_MANAGE`. Does not return.
+ */
+void taskFault(void);
+
+/**
+ * @brief Find stack high-water mark of a task.
+ *
+ * Searches the painted stack upwards for the first word not equal to
+ * `STACK_PAINT_PATTERN` and stores the result in the control block.
+ *
+ * @param id Task id
+ * @retval Used stack in bytes
+ */
+uint32_t taskStackScan(uint8_t id);
+
+/**
+ * @brief Print placement, stack usage and run statistics of every task.
+ */
+void taskReport(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_TASK_H_
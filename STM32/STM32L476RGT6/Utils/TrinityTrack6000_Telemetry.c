@@ -0,0 +1,197 @@
+#include <stdint.h>
+#include <string.h>
+#include <stm32l4xx_hal.h>
+
+#include <TrinityTrack6000_Telemetry.h>
+#include <TrinityTrack6000_MemInfo.h>
+#include <TrinityTrack6000_Errors.h>
+#include <TrinityTrack6000_UartTx.h>
+
+#define TELEMETRY_FRAME_SIZE  (TELEMETRY_PAYLOAD_SIZE+TELEMETRY_PAYLOAD_SIZE/254+2)
+
+// Record sizes are checked at compile time, so the schema can not silently overflow the payload
+#define TELEMETRY_MEMORY_SIZE(id,type,variable) +1+sizeof(type)
+#define TELEMETRY_BANK_LAYOUT_SIZE   (1+2*sizeof(uint32_t)+MEMINFO_NAME_SIZE)
+#define TELEMETRY_REGION_LAYOUT_SIZE (1+2+2*sizeof(uint32_t)+MEMINFO_NAME_SIZE)
+
+_Static_assert(MEMINFO_BANK_COUNT<=TELEMETRY_RECORD_REGION-TELEMETRY_RECORD_BANK,"Too many banks for record ids");
+_Static_assert(MEMINFO_REGION_COUNT<=0x80-TELEMETRY_RECORD_REGION,"Too many regions for record ids");
+_Static_assert(TELEMETRY_HEADER_SIZE TELEMETRY_MEMORY_RECORDS(TELEMETRY_MEMORY_SIZE)+
+               (MEMINFO_BANK_COUNT+MEMINFO_REGION_COUNT)*(1+sizeof(uint32_t))+TELEMETRY_CRC_SIZE<=TELEMETRY_PAYLOAD_SIZE,
+               "Memory records do not fit into TELEMETRY_PAYLOAD_SIZE");
+_Static_assert(TELEMETRY_HEADER_SIZE+MEMINFO_BANK_COUNT*TELEMETRY_BANK_LAYOUT_SIZE+
+               MEMINFO_REGION_COUNT*TELEMETRY_REGION_LAYOUT_SIZE+TELEMETRY_CRC_SIZE<=TELEMETRY_PAYLOAD_SIZE,
+               "Layout records do not fit into TELEMETRY_PAYLOAD_SIZE");
+
+// CRC-16/CCITT-FALSE, nibble table keeps flash cost at 32 bytes
+static const uint16_t telemetry_crcTable[16]={
+	0x0000,0x1021,0x2042,0x3063,0x4084,0x50A5,0x60C6,0x70E7,
+	0x8108,0x9129,0xA14A,0xB16B,0xC18C,0xD1AD,0xE1CE,0xF1EF
+};
+
+static uint8_t telemetry_payload[TELEMETRY_PAYLOAD_SIZE];
+static uint8_t telemetry_frame[TELEMETRY_FRAME_SIZE];
+static uint8_t telemetry_sequence=0;
+static uint8_t telemetry_framesSinceLayout=0;
+static uint32_t telemetry_lastTick=0;
+
+uint8_t telemetry_streaming=0;
+uint32_t telemetry_framesSent=0;
+uint32_t telemetry_framesDropped=0;
+
+uint16_t telemetryCrc16(const uint8_t*data,uint16_t length){
+	uint16_t crc=0xFFFF;
+
+	while(length--){
+		crc=(uint16_t)((crc<<4)^telemetry_crcTable[(crc>>12)^(*data>>4)]);
+		crc=(uint16_t)((crc<<4)^telemetry_crcTable[(crc>>12)^(*data&0x0F)]);
+		data++;
+	}
+	return crc;
+}
+
+uint16_t telemetryCobsEncode(const uint8_t*input,uint16_t length,uint8_t*output){
+	uint16_t codeIndex=0;
+	uint16_t writeIndex=1;
+	uint8_t code=1;
+
+	for(uint16_t i=0;i<length;i++){
+		if(input[i]==0){
+			output[codeIndex]=code;
+			codeIndex=writeIndex++;
+			code=1;
+			continue;
+		}
+		output[writeIndex++]=input[i];
+		if(++code==0xFF){
+			output[codeIndex]=code;
+			codeIndex=writeIndex++;
+			code=1;
+		}
+	}
+	output[codeIndex]=code;
+	output[writeIndex++]=0x00;
+
+	return writeIndex;
+}
+
+HAL_StatusTypeDef telemetrySendFrame(uint8_t frameType,const uint8_t*records,uint16_t length){
+	uint16_t crc;
+	uint16_t frameLength;
+
+	if(length>TELEMETRY_PAYLOAD_SIZE-TELEMETRY_HEADER_SIZE-TELEMETRY_CRC_SIZE){
+		return HAL_ERROR;
+	}
+	telemetry_payload[0]=TELEMETRY_SCHEMA_VERSION;
+	telemetry_payload[1]=frameType;
+	telemetry_payload[2]=telemetry_sequence;
+	if(records!=&telemetry_payload[TELEMETRY_HEADER_SIZE]){
+		memmove(&telemetry_payload[TELEMETRY_HEADER_SIZE],records,length);
+	}
+	length+=TELEMETRY_HEADER_SIZE;
+
+	crc=telemetryCrc16(telemetry_payload,length);
+	telemetry_payload[length++]=(uint8_t)crc;
+	telemetry_payload[length++]=(uint8_t)(crc>>8);
+
+	frameLength=telemetryCobsEncode(telemetry_payload,length,telemetry_frame);
+	if(uartTxWrite(telemetry_frame,frameLength)!=HAL_OK){
+		telemetry_framesDropped++;
+		return HAL_BUSY;
+	}
+	telemetry_sequence++;
+	telemetry_framesSent++;
+
+	return HAL_OK;
+}
+
+// Appends id and value, Cortex-M4 is little endian so values are copied as they are stored
+static uint8_t*telemetryPut(uint8_t*record,uint8_t id,const void*value,uint8_t size){
+	*record++=id;
+	memcpy(record,value,size);
+	return record+size;
+}
+
+// Name is padded with NUL to a fixed size, so records keep a fixed length
+static uint8_t*telemetryPutName(uint8_t*record,const char*name){
+	strncpy((char*)record,name,MEMINFO_NAME_SIZE);
+	return record+MEMINFO_NAME_SIZE;
+}
+
+void telemetrySendMemory(void){
+	uint8_t*record=&telemetry_payload[TELEMETRY_HEADER_SIZE];
+
+	#define TELEMETRY_MEMORY_PUT(id,type,variable) \
+		record=telemetryPut(record,(id),&(variable),sizeof(type));
+	TELEMETRY_MEMORY_RECORDS(TELEMETRY_MEMORY_PUT)
+	#undef TELEMETRY_MEMORY_PUT
+
+	for(uint8_t bank=0;bank<MEMINFO_BANK_COUNT;bank++){
+		record=telemetryPut(record,TELEMETRY_RECORD_BANK+bank,&ramDiagnosticsBank_used[bank],sizeof(uint32_t));
+	}
+	for(uint8_t region=0;region<MEMINFO_REGION_COUNT;region++){
+		record=telemetryPut(record,TELEMETRY_RECORD_REGION+region,&ramDiagnosticsRegion_used[region],sizeof(uint32_t));
+	}
+
+	telemetrySendFrame(TELEMETRY_FRAME_MEMORY,&telemetry_payload[TELEMETRY_HEADER_SIZE],
+	                   (uint16_t)(record-&telemetry_payload[TELEMETRY_HEADER_SIZE]));
+}
+
+void telemetrySendLayout(void){
+	uint8_t*record=&telemetry_payload[TELEMETRY_HEADER_SIZE];
+	uint32_t address[2];
+
+	for(uint8_t i=0;i<MEMINFO_BANK_COUNT;i++){
+		const MemBank*bank=&ramDiagnostics_banks[i];
+
+		address[0]=(uint32_t)bank->start;
+		address[1]=(uint32_t)bank->end;
+		record=telemetryPut(record,TELEMETRY_RECORD_BANK+i,address,sizeof(address));
+		record=telemetryPutName(record,bank->name);
+	}
+	for(uint8_t i=0;i<MEMINFO_REGION_COUNT;i++){
+		const MemRegion*region=&ramDiagnostics_regions[i];
+
+		*record++=TELEMETRY_RECORD_REGION+i;
+		*record++=region->bank;
+		*record++=region->flags;
+		address[0]=(uint32_t)region->start;
+		address[1]=(uint32_t)region->end;
+		memcpy(record,address,sizeof(address));
+		record+=sizeof(address);
+		record=telemetryPutName(record,region->name);
+	}
+
+	telemetrySendFrame(TELEMETRY_FRAME_LAYOUT,&telemetry_payload[TELEMETRY_HEADER_SIZE],
+	                   (uint16_t)(record-&telemetry_payload[TELEMETRY_HEADER_SIZE]));
+}
+
+void telemetryStart(void){
+	telemetry_streaming=1;
+	telemetry_framesSinceLayout=0;
+	telemetry_lastTick=HAL_GetTick();
+	telemetrySendLayout();
+}
+
+void telemetryStop(void){
+	telemetry_streaming=0;
+}
+
+void telemetryProcess(void){
+	if(!telemetry_streaming||HAL_GetTick()-telemetry_lastTick<TELEMETRY_PERIOD_MS){
+		return;
+	}
+	telemetry_lastTick+=TELEMETRY_PERIOD_MS;
+	// After a long stall continue from now instead of sending a burst of frames
+	if(HAL_GetTick()-telemetry_lastTick>=TELEMETRY_PERIOD_MS){
+		telemetry_lastTick=HAL_GetTick();
+	}
+
+	ramDiagnosticsRefresh();
+	telemetrySendMemory();
+
+	if(++telemetry_framesSinceLayout>=TELEMETRY_LAYOUT_INTERVAL){
+		telemetry_framesSinceLayout=0;
+		telemetrySendLayout();
+	}
+}
@@ -0,0 +1,163 @@
+/**
+ * @file TrinityTrack6000_Telemetry.h
+ * @brief Binary framed memory telemetry for TrinityTrack6000 project.
+ *
+ * Compact alternative to the ASCII RAM tables. Every frame is
+ *
+ *     COBS( version | frameType | sequence | records... | CRC16 ) 0x00
+ *
+ * where each record is an id byte followed by the little endian value.
+ * The size of a value is defined by the record id in the schema below,
+ * any change of the schema must increase `TELEMETRY_SCHEMA_VERSION`.
+ * CRC is CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over the header
+ * and records. Frames are delimited by 0x00, so a receiver can resync
+ * on any frame boundary.
+ *
+ * Frame types:
+ * - `TELEMETRY_FRAME_MEMORY` current values of all `ramDiagnostics*`
+ *   variables and `global_error_code`
+ * - `TELEMETRY_FRAME_LAYOUT` names and start/end addresses of the banks and
+ *   regions of `MEMINFO_BANKS`/`MEMINFO_REGIONS`, sent when streaming starts and every `TELEMETRY_LAYOUT_INTERVAL` frames
+ * - `TELEMETRY_FRAME_LOG` 16 bit log token followed by 32 bit arguments
+ *
+ * Frames are decoded on the host by `Scripts/telemetry_decode.py`, which
+ * renders the same tables as `ramDiagnosticsGeneral()` and friends.
+ *
+ * @date 2025.09.13
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_TELEMETRY_H_
+    #define _TRINITYTRACK6000_TELEMETRY_H_
+
+#include <stdint.h>
+
+#include <TrinityTrack6000_Config.h>
+#include <TrinityTrack6000_Placement.h>
+
+#define TELEMETRY_SCHEMA_VERSION  3
+#define TELEMETRY_PAYLOAD_SIZE    320
+#define TELEMETRY_LAYOUT_INTERVAL 50
+#define TELEMETRY_HEADER_SIZE     3
+#define TELEMETRY_CRC_SIZE        2
+
+/**
+ * @brief Encoded size of frame with given records length, including COBS overhead and delimiter
+ */
+#define TELEMETRY_FRAME_SIZE_MAX(length) ((length)+TELEMETRY_HEADER_SIZE+TELEMETRY_CRC_SIZE+ \
+                                          ((length)+TELEMETRY_HEADER_SIZE+TELEMETRY_CRC_SIZE)/254+2)
+
+/** @name Frame types
+ *  @{
+ */
+#define TELEMETRY_FRAME_MEMORY 0x01 /**< Memory usage values */
+#define TELEMETRY_FRAME_LAYOUT 0x02 /**< Memory layout addresses */
+#define TELEMETRY_FRAME_LOG    0x03 /**< Tokenized log message, see TrinityTrack6000_Log.h */
+/** @} */
+
+/**
+ * @brief Memory frame scalar records X(id,type,variable)
+ *
+ * Followed by generic records of the MemInfo tables:
+ * - `TELEMETRY_RECORD_BANK+bank` uint32_t used bytes of bank
+ * - `TELEMETRY_RECORD_REGION+region` uint32_t used bytes of region
+ */
+#define TELEMETRY_MEMORY_RECORDS(X) \
+    X(0x01,uint32_t,ramDiagnosticsGeneral_total_size) \
+    X(0x02,uint32_t,ramDiagnosticsGeneral_used) \
+    X(0x03,uint32_t,ramDiagnosticsRAM1_lastMSP) \
+    X(0x04,uint32_t,ramDiagnosticsRAM1_lastHeapEnd) \
+    X(0x05,uint32_t,ramDiagnosticsRAM1_stackHighWater) \
+    X(0x10,uint32_t,global_error_code)
+
+/**
+ * @brief Generic record ids, offset by bank or region index
+ *
+ * In layout frames bank records are start, end (uint32_t) and name
+ * (`MEMINFO_NAME_SIZE` chars), region records are bank, flags (uint8_t),
+ * start, end (uint32_t) and name.
+ * @{
+ */
+#define TELEMETRY_RECORD_BANK   0x20 /**< Up to 32 banks */
+#define TELEMETRY_RECORD_REGION 0x40 /**< Up to 64 regions */
+/** @} */
+
+/**
+ * @brief Telemetry statistics
+ * @{
+ */
+extern uint8_t telemetry_streaming;      /**< 1 if memory frames are streamed periodically */
+extern uint32_t telemetry_framesSent;    /**< Frames enqueued to UART */
+extern uint32_t telemetry_framesDropped; /**< Frames rejected by full UART transmitter */
+/** @} */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Compute CRC-16/CCITT-FALSE.
+ *
+ * Runs from SRAM2 (`RAM2_FUNC`) like the COBS encoder, both touch every byte of every frame.
+ *
+ * @param data Pointer to data
+ * @param length Number of bytes
+ * @retval CRC value
+ */
+uint16_t telemetryCrc16(const uint8_t*data,uint16_t length) RAM2_FUNC;
+
+/**
+ * @brief COBS encode data and append frame delimiter.
+ *
+ * `output` must hold at least `length+length/254+2` bytes.
+ *
+ * @param input Data to encode
+ * @param length Number of bytes to encode
+ * @param output Encoded frame
+ * @retval Number of bytes written to output including 0x00 delimiter
+ */
+uint16_t telemetryCobsEncode(const uint8_t*input,uint16_t length,uint8_t*output) RAM2_FUNC;
+
+/**
+ * @brief Build and send one telemetry frame.
+ *
+ * Adds header and CRC to records, encodes the frame and enqueues it.
+ *
+ * @param frameType One of TELEMETRY_FRAME_* values
+ * @param records Encoded records
+ * @param length Number of bytes of records
+ * @retval HAL_OK if frame was enqueued
+ */
+HAL_StatusTypeDef telemetrySendFrame(uint8_t frameType,const uint8_t*records,uint16_t length);
+
+/**
+ * @brief Send memory usage frame with current diagnostics values.
+ */
+void telemetrySendMemory(void);
+
+/**
+ * @brief Send memory layout frame.
+ */
+void telemetrySendLayout(void);
+
+/**
+ * @brief Start periodic streaming of memory frames.
+ */
+void telemetryStart(void);
+
+/**
+ * @brief Stop periodic streaming of memory frames.
+ */
+void telemetryStop(void);
+
+/**
+ * @brief Refresh diagnostics and send frame when streaming period elapsed.
+ *
+ * Must be called periodically from thread context (main loop).
+ */
+void telemetryProcess(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_TELEMETRY_H_
@@ -0,0 +1,101 @@
+#include <stdint.h>
+#include <stm32l4xx_hal.h>
+
+#include <TrinityTrack6000_UartRx.h>
+#include <TrinityTrack6000_UartTx.h>
+#include <TrinityTrack6000_Commands.h>
+#include <TrinityTrack6000_Errors.h>
+
+extern void Error_Handler(void);
+
+static uint8_t uartRx_buffer[UART_RX_BUFFER_SIZE];
+static uint16_t uartRx_readPosition=0; // Next byte of uartRx_buffer to be processed
+
+static char uartRx_line[UART_RX_LINE_SIZE];
+static uint8_t uartRx_lineLength=0;
+static uint8_t uartRx_lineOverflow=0;
+
+uint32_t uartRx_lines=0;
+uint32_t uartRx_overflowLines=0;
+uint32_t uartRx_errors=0;
+
+static void uartRxStart(void){
+	uartRx_readPosition=0;
+
+	if(HAL_UARTEx_ReceiveToIdle_DMA(&uart,uartRx_buffer,UART_RX_BUFFER_SIZE)!=HAL_OK){
+		global_error_code=ERROR_HAL_UART_ReceiveToIdle_DMA;
+		Error_Handler();
+	}
+	// Only idle line and buffer wrap events are of interest
+	__HAL_DMA_DISABLE_IT(&uart_dma_rx,DMA_IT_HT);
+}
+
+static void uartRxEndLine(void){
+	if(uartRx_lineLength==0){
+		return;
+	}
+	uartRx_line[uartRx_lineLength]='\0';
+	uartRx_lines++;
+	if(uartRx_lineOverflow){
+		uartRx_overflowLines++;
+	}
+	commandsLineReceived(uartRx_line,uartRx_lineLength);
+
+	uartRx_lineLength=0;
+	uartRx_lineOverflow=0;
+}
+
+static void uartRxConsume(uint16_t end){
+	while(uartRx_readPosition<end){
+		char c=(char)uartRx_buffer[uartRx_readPosition++];
+
+		if(c=='\r'||c=='\n'){
+			uartRxEndLine();
+		}
+		else if(uartRx_lineLength<UART_RX_LINE_SIZE-1){
+			uartRx_line[uartRx_lineLength++]=c;
+		}
+		else{
+			uartRx_lineOverflow=1;
+		}
+	}
+	if(uartRx_readPosition>=UART_RX_BUFFER_SIZE){
+		uartRx_readPosition=0;
+	}
+}
+
+void uartRxInit(void){
+	uartRx_lineLength=0;
+	uartRx_lineOverflow=0;
+
+	uartRx_lines=0;
+	uartRx_overflowLines=0;
+	uartRx_errors=0;
+
+	uartRxStart();
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef*huart,uint16_t size){
+	if(huart!=&uart){
+		return;
+	}
+	// size is the position of DMA write pointer in circular buffer, a partial line is kept until its \r or \n
+	uartRxConsume(size);
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef*huart){
+	if(huart!=&uart){
+		return;
+	}
+	uartRx_errors++;
+
+	// Blocking errors abort the transfers, restart whichever direction stopped
+	if(huart->RxState==HAL_UART_STATE_READY){
+		uartRx_lineLength=0;
+		uartRx_lineOverflow=0;
+		uartRxStart();
+	}
+	if(huart->gState==HAL_UART_STATE_READY){
+		uartTxTransferComplete();
+	}
+}
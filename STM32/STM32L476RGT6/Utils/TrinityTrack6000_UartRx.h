@@ -0,0 +1,51 @@
+/**
+ * @file TrinityTrack6000_UartRx.h
+ * @brief Idle-line framed UART receiver for TrinityTrack6000 project.
+ *
+ * USART2 receives into a circular DMA buffer. The CPU is interrupted only
+ * when the line goes idle after a burst of characters (or when the buffer
+ * wraps), so nothing is spent while the link is quiet. Received characters
+ * are assembled into lines which are handed to the diagnostics command
+ * parser (`commandsLineReceived()`).
+ *
+ * A line ends only with `\r` or `\n`. A terminal sends every keystroke on
+ * its own and the line goes idle in between, so idle events only flush the
+ * received bytes and a partial line is kept across them. A command is
+ * dispatched within one idle period of its line end.
+ *
+ * @date 2025.09.10
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_UARTRX_H_
+    #define _TRINITYTRACK6000_UARTRX_H_
+
+#include <stdint.h>
+
+#include <TrinityTrack6000_Config.h>
+
+/**
+ * @brief UART receiver statistics
+ * @{
+ */
+extern uint32_t uartRx_lines;         /**< Number of lines handed to the parser */
+extern uint32_t uartRx_overflowLines; /**< Number of lines truncated to UART_RX_LINE_SIZE */
+extern uint32_t uartRx_errors;        /**< Number of UART errors that restarted reception */
+/** @} */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Initialize UART receiver.
+ *
+ * Starts circular DMA reception with idle-line detection.
+ * Must be called after `HAL_UART_Init()`.
+ */
+void uartRxInit(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_UARTRX_H_
@@ -0,0 +1,114 @@
+#include <stdint.h>
+#include <string.h>
+#include <stm32l4xx_hal.h>
+#include <core_cm4.h>
+
+#include <TrinityTrack6000_UartTx.h>
+
+static uint8_t uartTx_buffer[UART_TX_BUFFER_SIZE] __attribute__((aligned(4)));
+
+// Free running indexes, masked with UART_TX_BUFFER_MASK on access
+static volatile uint32_t uartTx_head=0;     // Written only by uartTxWrite()
+static volatile uint32_t uartTx_tail=0;     // Written only by DMA completion
+static volatile uint16_t uartTx_inFlight=0; // Size of chunk currently sent by DMA
+
+uint32_t uartTx_droppedBytes=0;
+uint32_t uartTx_enqueueCyclesLast=0;
+uint32_t uartTx_enqueueCyclesMax=0;
+uint32_t uartTx_peakUsage=0;
+
+// Must be called with interrupts masked or from DMA/UART interrupt
+static void uartTxStartNext(void){
+	uint32_t tail=uartTx_tail;
+	uint32_t pending=uartTx_head-tail;
+	uint32_t offset=tail&UART_TX_BUFFER_MASK;
+	uint32_t chunk=UART_TX_BUFFER_SIZE-offset; // DMA can only send contiguous memory
+
+	if(uartTx_inFlight!=0||pending==0){
+		return;
+	}
+	if(chunk>pending){
+		chunk=pending;
+	}
+	if(chunk>UINT16_MAX){
+		chunk=UINT16_MAX;
+	}
+	uartTx_inFlight=(uint16_t)chunk;
+
+	if(HAL_UART_Transmit_DMA(&uart,&uartTx_buffer[offset],(uint16_t)chunk)!=HAL_OK){
+		// Transmitter busy with a blocking transfer, next write or completion retries
+		uartTx_inFlight=0;
+	}
+}
+
+void uartTxInit(void){
+	uartTx_head=0;
+	uartTx_tail=0;
+	uartTx_inFlight=0;
+
+	uartTx_droppedBytes=0;
+	uartTx_enqueueCyclesLast=0;
+	uartTx_enqueueCyclesMax=0;
+	uartTx_peakUsage=0;
+
+	CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL|=DWT_CTRL_CYCCNTENA_Msk;
+}
+
+HAL_StatusTypeDef uartTxWrite(const uint8_t*data,uint16_t length){
+	uint32_t start=UART_TX_CYCLES();
+	uint32_t head=uartTx_head;
+	uint32_t used=head-uartTx_tail;
+	uint32_t offset=head&UART_TX_BUFFER_MASK;
+	uint32_t firstPart=UART_TX_BUFFER_SIZE-offset;
+
+	if(length>UART_TX_BUFFER_SIZE-used){
+		uartTx_droppedBytes+=length;
+		return HAL_BUSY;
+	}
+	if(firstPart>length){
+		firstPart=length;
+	}
+	memcpy(&uartTx_buffer[offset],data,firstPart);
+	memcpy(uartTx_buffer,data+firstPart,length-firstPart);
+
+	// Data must be visible before DMA can see the new head
+	__DMB();
+	uartTx_head=head+length;
+
+	if(used+length>uartTx_peakUsage){
+		uartTx_peakUsage=used+length;
+	}
+
+	if(uartTx_inFlight==0){
+		UART_TX_ENTER_CRITICAL();
+		uartTxStartNext();
+		UART_TX_EXIT_CRITICAL();
+	}
+
+	uartTx_enqueueCyclesLast=UART_TX_CYCLES()-start;
+	if(uartTx_enqueueCyclesLast>uartTx_enqueueCyclesMax){
+		uartTx_enqueueCyclesMax=uartTx_enqueueCyclesLast;
+	}
+	return HAL_OK;
+}
+
+uint8_t uartTxIsIdle(void){
+	return (uartTx_inFlight==0)&&(uartTx_head==uartTx_tail);
+}
+
+uint32_t uartTxPending(void){
+	return uartTx_head-uartTx_tail;
+}
+
+void uartTxTransferComplete(void){
+	uartTx_tail+=uartTx_inFlight;
+	uartTx_inFlight=0;
+	uartTxStartNext();
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef*huart){
+	if(huart==&uart){
+		uartTxTransferComplete();
+	}
+}
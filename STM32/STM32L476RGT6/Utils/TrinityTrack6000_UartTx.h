@@ -0,0 +1,122 @@
+/**
+ * @file TrinityTrack6000_UartTx.h
+ * @brief Non-blocking, DMA driven UART transmitter for TrinityTrack6000 project.
+ *
+ * All diagnostics output is enqueued into a ring buffer and sent by
+ * DMA1 Channel7 in the background. Callers only copy bytes into the
+ * ring, the DMA transfer complete interrupt chains the next contiguous
+ * chunk of the ring until it is empty.
+ *
+ * Features:
+ * - Power of 2 ring buffer of `UART_TX_BUFFER_SIZE` bytes
+ * - All-or-nothing enqueue, messages that do not fit are dropped and counted
+ * - Enqueue latency (DWT cycles) and dropped bytes counters
+ *
+ * Usage:
+ * - Call `uartTxInit()` after `HAL_UART_Init()`
+ * - Call `uartTxWrite()` or `uartTxWriteMessage()` from thread context to send data
+ *
+ * Hardware access is limited to `HAL_UART_Transmit_DMA()`, `UART_TX_CYCLES()`
+ * and the critical section macros. `Scripts/mock` replaces them on a host,
+ * `Scripts/uart_tx_test.c` runs the ring against the mocked USART/DMA:
+ *
+ *     gcc -O2 -Wall -Wextra -IScripts/mock -IInclude -IUtils Scripts/uart_tx_test.c \
+ *         Utils/TrinityTrack6000_UartTx.c -o uart_tx_test
+ *     ./uart_tx_test
+ *
+ * @date 2025.09.10
+ * @author Alan Kudełko
+ */
+#ifndef _TRINITYTRACK6000_UARTTX_H_
+    #define _TRINITYTRACK6000_UARTTX_H_
+
+#include <stdint.h>
+
+#include <TrinityTrack6000_Config.h>
+#include <TrinityTrack6000_Message.h>
+
+#define UART_TX_BUFFER_MASK (UART_TX_BUFFER_SIZE-1)
+
+#if (UART_TX_BUFFER_SIZE&UART_TX_BUFFER_MASK)!=0
+    #error "UART_TX_BUFFER_SIZE must be a power of 2"
+#endif
+
+// Cycle counter used for latency measurement
+#ifndef UART_TX_CYCLES
+    #define UART_TX_CYCLES() (DWT->CYCCNT)
+#endif
+
+// Critical section used to start DMA transfer from thread context
+#ifndef UART_TX_ENTER_CRITICAL
+    #define UART_TX_ENTER_CRITICAL() uint32_t uartTxPrimask=__get_PRIMASK();__disable_irq()
+    #define UART_TX_EXIT_CRITICAL()  __set_PRIMASK(uartTxPrimask)
+#endif
+
+/**
+ * @brief UART transmitter statistics
+ * @{
+ */
+extern uint32_t uartTx_droppedBytes;       /**< Number of bytes rejected because the ring was full */
+extern uint32_t uartTx_enqueueCyclesLast;  /**< Duration of the last enqueue in CPU cycles */
+extern uint32_t uartTx_enqueueCyclesMax;   /**< Longest enqueue in CPU cycles */
+extern uint32_t uartTx_peakUsage;          /**< Highest number of bytes waiting in the ring */
+/** @} */
+
+#ifdef __cplusplus
+    extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Initialize UART transmitter.
+ *
+ * Resets the ring buffer and statistics and enables the DWT cycle counter
+ * used for latency measurement. Must be called after `HAL_UART_Init()`.
+ */
+void uartTxInit(void);
+
+/**
+ * @brief Enqueue data for transmission.
+ *
+ * Copies `length` bytes into the ring buffer and starts DMA if the
+ * transmitter is idle. Data is enqueued as a whole or not at all.
+ * Must not be called from interrupts.
+ *
+ * @param data Pointer to data to send
+ * @param length Number of bytes to send
+ * @retval HAL_OK if data was enqueued, HAL_BUSY if the ring had not enough space
+ */
+HAL_StatusTypeDef uartTxWrite(const uint8_t*data,uint16_t length);
+
+/**
+ * @brief Enqueue constant message for transmission.
+ * @param message Message with precomputed length
+ * @retval HAL_OK if message was enqueued, HAL_BUSY if the ring had not enough space
+ */
+static inline HAL_StatusTypeDef uartTxWriteMessage(const Message*message){
+    return uartTxWrite((const uint8_t*)message->text,message->length);
+}
+
+/**
+ * @brief Check whether all enqueued data was sent.
+ * @retval 1 if ring is empty and no DMA transfer is in progress, 0 otherwise
+ */
+uint8_t uartTxIsIdle(void);
+
+/**
+ * @brief Number of bytes waiting in the ring buffer.
+ */
+uint32_t uartTxPending(void);
+
+/**
+ * @brief DMA transfer complete handler.
+ *
+ * Releases the transmitted chunk and starts the next one.
+ * Called from `HAL_UART_TxCpltCallback()`.
+ */
+void uartTxTransferComplete(void);
+
+#ifdef __cplusplus
+    }
+#endif // __cplusplus
+
+#endif // _TRINITYTRACK6000_UARTTX_H_